@@ -0,0 +1,35 @@
+// Releases the blob reference held by a Buffer created by RawcontentBuffer
+// once the Buffer has been garbage collected.
+static void GitBlobRawcontentBufferFree(char *data, void *hint) {
+  git_blob_free(static_cast<git_blob *>(hint));
+}
+
+/*
+ * Wraps the raw content of the blob in a Buffer without copying it.
+ * The Buffer holds its own reference to the blob, so the content stays valid
+ * until the Buffer is garbage collected, even if the Blob is freed first.
+ * @return Buffer
+ */
+NAN_METHOD(GitBlob::RawcontentBuffer) {
+  git_blob *blob = Nan::ObjectWrap::Unwrap<GitBlob>(info.This())->GetValue();
+
+  git_off_t size = git_blob_rawsize(blob);
+  // Nan::NewBuffer takes the length as a uint32_t
+  if (size > (git_off_t)node::Buffer::kMaxLength || size > (git_off_t)UINT32_MAX) {
+    return Nan::ThrowError("Blob is too large to be wrapped in a Buffer.");
+  }
+
+  git_blob *blobReference;
+  if (git_blob_dup(&blobReference, blob) != GIT_OK) {
+    return Nan::ThrowError("Could not reference the blob.");
+  }
+
+  info.GetReturnValue().Set(
+    Nan::NewBuffer(
+      (char *)git_blob_rawcontent(blobReference),
+      (uint32_t)size,
+      GitBlobRawcontentBufferFree,
+      blobReference
+    ).ToLocalChecked()
+  );
+}
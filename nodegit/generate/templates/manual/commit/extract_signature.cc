@@ -77,6 +77,7 @@ void GitCommit::ExtractSignatureWorker::Execute()
 
   {
     LockMaster lockMaster(
+      LockMaster::Shared,
       /*asyncAction: */true,
       baton->repo
     );
@@ -0,0 +1,160 @@
+/*
+ * Looks up many commits on one worker.
+ * Commits that don't exist are returned as null.
+ * @param Repository repo
+ * @param Array<Oid|String> oids
+ * @param Commit[] callback
+ */
+NAN_METHOD(GitCommit::LookupMany)
+{
+  if (info.Length() == 0 || !GitRepository::HasInstance(info[0])) {
+    return Nan::ThrowTypeError("Repository repo is required.");
+  }
+
+  if (info.Length() == 1 || !info[1]->IsArray()) {
+    return Nan::ThrowError("Array oids is required.");
+  }
+
+  if (info.Length() == 2 || !info[2]->IsFunction()) {
+    return Nan::ThrowError("Callback is required and must be a Function.");
+  }
+
+  v8::Local<v8::Array> oidsArray = v8::Local<v8::Array>::Cast(info[1]);
+  std::vector<git_oid> *oids = new std::vector<git_oid>(oidsArray->Length());
+  for (unsigned int i = 0; i < oidsArray->Length(); i++) {
+    v8::Local<v8::Value> oid = Nan::Get(oidsArray, i).ToLocalChecked();
+    if (oid->IsString()) {
+      Nan::Utf8String oidString(Nan::To<v8::String>(oid).ToLocalChecked());
+      if (git_oid_fromstr(&oids->at(i), *oidString) != GIT_OK) {
+        delete oids;
+        if (git_error_last()) {
+          return Nan::ThrowError(git_error_last()->message);
+        } else {
+          return Nan::ThrowError("Unknown Error");
+        }
+      }
+    } else if (GitOid::HasInstance(oid)) {
+      git_oid_cpy(&oids->at(i), Nan::ObjectWrap::Unwrap<GitOid>(Nan::To<v8::Object>(oid).ToLocalChecked())->GetValue());
+    } else {
+      delete oids;
+      return Nan::ThrowTypeError("Every oid must be an Oid or a String.");
+    }
+  }
+
+  LookupManyBaton* baton = new LookupManyBaton;
+
+  baton->error_code = GIT_OK;
+  baton->error = NULL;
+  baton->repo = Nan::ObjectWrap::Unwrap<GitRepository>(Nan::To<v8::Object>(info[0]).ToLocalChecked())->GetValue();
+  baton->oids = oids;
+  baton->out = new std::vector<git_commit *>;
+  baton->out->reserve(oids->size());
+
+  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[2]));
+  LookupManyWorker *worker = new LookupManyWorker(baton, callback);
+  worker->SaveToPersistent("repo", info[0]);
+
+  AsyncLibgit2QueueWorker(worker, baton->repo);
+  return;
+}
+
+void GitCommit::LookupManyWorker::Execute()
+{
+  git_error_clear();
+
+  LockMaster lockMaster(LockMaster::Shared, true, baton->repo);
+
+  for (size_t i = 0; i < baton->oids->size(); i++) {
+    git_commit *commit = NULL;
+    baton->error_code = git_commit_lookup(&commit, baton->repo, &baton->oids->at(i));
+
+    if (baton->error_code == GIT_ENOTFOUND) {
+      git_error_clear();
+      baton->error_code = GIT_OK;
+    } else if (baton->error_code != GIT_OK) {
+      if (git_error_last() != NULL) {
+        baton->error = git_error_dup(git_error_last());
+      }
+
+      // unwind and return
+      while (baton->out->size()) {
+        git_commit *commitToFree = baton->out->back();
+        baton->out->pop_back();
+        git_commit_free(commitToFree);
+      }
+
+      delete baton->out;
+      baton->out = NULL;
+      break;
+    }
+
+    baton->out->push_back(commit);
+  }
+
+  delete baton->oids;
+  baton->oids = NULL;
+}
+
+void GitCommit::LookupManyWorker::HandleOKCallback()
+{
+  if (baton->out != NULL)
+  {
+    unsigned int size = baton->out->size();
+    Local<Array> result = Nan::New<Array>(size);
+    for (unsigned int i = 0; i < size; i++) {
+      git_commit *commit = baton->out->at(i);
+      if (commit == NULL) {
+        Nan::Set(result, Nan::New<Number>(i), Nan::Null());
+        continue;
+      }
+
+      Nan::Set(
+        result,
+        Nan::New<Number>(i),
+        GitCommit::New(
+          commit,
+          true,
+          Nan::To<v8::Object>(GitRepository::New(git_commit_owner(commit), true)).ToLocalChecked()
+        )
+      );
+    }
+
+    delete baton->out;
+
+    Local<v8::Value> argv[2] = {
+      Nan::Null(),
+      result
+    };
+    callback->Call(2, argv, async_resource);
+  }
+  else if (baton->error)
+  {
+    Local<v8::Object> err = Nan::To<v8::Object>(Nan::Error(baton->error->message)).ToLocalChecked();
+    Nan::Set(err, Nan::New("errno").ToLocalChecked(), Nan::New(baton->error_code));
+    Nan::Set(err, Nan::New("errorFunction").ToLocalChecked(), Nan::New("Commit.lookupMany").ToLocalChecked());
+    Local<v8::Value> argv[1] = {
+      err
+    };
+    callback->Call(1, argv, async_resource);
+    if (baton->error->message)
+    {
+      free((void *)baton->error->message);
+    }
+
+    free((void *)baton->error);
+  }
+  else if (baton->error_code < 0)
+  {
+    Local<v8::Object> err = Nan::To<v8::Object>(Nan::Error("Commit lookupMany has thrown an error.")).ToLocalChecked();
+    Nan::Set(err, Nan::New("errno").ToLocalChecked(), Nan::New(baton->error_code));
+    Nan::Set(err, Nan::New("errorFunction").ToLocalChecked(), Nan::New("Commit.lookupMany").ToLocalChecked());
+    Local<v8::Value> argv[1] = {
+      err
+    };
+    callback->Call(1, argv, async_resource);
+  }
+  else
+  {
+    callback->Call(0, NULL, async_resource);
+  }
+}
@@ -3,6 +3,7 @@
 
 #include <nan.h>
 #include <uv.h>
+#include <git2.h>
 #include "../include/thread_pool.h"
 #include "../include/nodegit.h"
 
@@ -24,10 +25,100 @@ NAN_INLINE void AsyncLibgit2Execute (void *vworker) {
   worker->Execute();
 }
 
+// The repository an argument of an async call belongs to, used to look up
+// the thread pool priority set for that repository.
+// By default, an argument doesn't belong to any repository.
+template<typename T>
+inline const void *AsyncLibgit2Owner(const T *t) {
+  return NULL;
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_repository *repo) {
+  return repo;
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_blob *blob) {
+  return git_blob_owner(blob);
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_commit *commit) {
+  return git_commit_owner(commit);
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_index *index) {
+  return git_index_owner(index);
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_object *object) {
+  return git_object_owner(object);
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_reference *reference) {
+  return git_reference_owner(reference);
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_remote *remote) {
+  return git_remote_owner(remote);
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_revwalk *walk) {
+  return git_revwalk_repository(const_cast<git_revwalk *>(walk));
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_submodule *submodule) {
+  return git_submodule_owner(const_cast<git_submodule *>(submodule));
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_tag *tag) {
+  return git_tag_owner(tag);
+}
+
+template<> inline const void *AsyncLibgit2Owner(const git_tree *tree) {
+  return git_tree_owner(tree);
+}
+
+// base case for variadic template unwinding - nothing in the call
+// has a priority of its own
+NAN_INLINE ThreadPool::Priority AsyncLibgit2Priority() {
+  return ThreadPool::Interactive;
+}
+
+// the priority of the first argument whose repository has one
+template<typename T, typename... Types>
+NAN_INLINE ThreadPool::Priority AsyncLibgit2Priority(const T *t, const Types*... args) {
+  ThreadPool::Priority priority;
+  if (t && libgit2ThreadPool.GetOwnerPriority(AsyncLibgit2Owner(t), priority)) {
+    return priority;
+  }
+  return AsyncLibgit2Priority(args...);
+}
+
+// base case for variadic template unwinding - nothing in the call
+// belongs to a repository
+NAN_INLINE const void *AsyncLibgit2FirstOwner() {
+  return NULL;
+}
+
+// the repository of the first argument that belongs to one
+template<typename T, typename... Types>
+NAN_INLINE const void *AsyncLibgit2FirstOwner(const T *t, const Types*... args) {
+  const void *owner = t ? AsyncLibgit2Owner(t) : NULL;
+  return owner ? owner : AsyncLibgit2FirstOwner(args...);
+}
+
 // Schedules the AsyncWorker to run on the dedicated libgit2 thread / event loop,
-// and on completion AsyncLibgit2Complete on the default loop
-NAN_INLINE void AsyncLibgit2QueueWorker (Nan::AsyncWorker* worker) {
-  libgit2ThreadPool.QueueWork(AsyncLibgit2Execute, AsyncLibgit2Complete, worker);
+// and on completion AsyncLibgit2Complete on the default loop.
+// The work is queued with the priority currently set on the thread pool,
+// or else with the priority of the repository the arguments belong to,
+// and on behalf of that repository for affinity scheduling.
+template<typename... Types>
+NAN_INLINE void AsyncLibgit2QueueWorker (Nan::AsyncWorker* worker, const Types*... args) {
+  const void *owner = AsyncLibgit2FirstOwner(args...);
+  ThreadPool::Priority priority;
+  if (!libgit2ThreadPool.GetCurrentPriority(priority)) {
+    priority = AsyncLibgit2Priority(args...);
+  }
+  libgit2ThreadPool.QueueWork(AsyncLibgit2Execute, AsyncLibgit2Complete, worker, priority, owner);
 }
 
 #endif
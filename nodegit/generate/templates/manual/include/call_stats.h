@@ -0,0 +1,121 @@
+#ifndef CALL_STATS_H
+#define CALL_STATS_H
+
+#include <uv.h>
+#include <nan.h>
+#include <stdint.h>
+#include <vector>
+
+// Optional timing of async calls, per JavaScript function. While disabled,
+// calls only check a flag. Everything is recorded when a call completes,
+// so histograms are only touched on the loop thread.
+class CallStats {
+public:
+  // Durations in log2 buckets of nanoseconds, the last bucket holding
+  // everything longer
+  class Histogram {
+    static const int bucketCount = 40;
+
+    uint64_t count;
+    uint64_t total;
+    uint64_t max;
+    uint64_t buckets[bucketCount];
+
+    // upper bound, in nanoseconds, of the duration of the given fraction
+    // of the recorded calls
+    uint64_t Percentile(double fraction) const;
+
+  public:
+    Histogram() {
+      Reset();
+    }
+
+    void Record(uint64_t duration);
+    void Reset();
+    bool IsEmpty() const {
+      return count == 0;
+    }
+    v8::Local<v8::Object> ToJavascript() const;
+  };
+
+  struct Function {
+    const char *name;
+    // from queueing the call to the start of its work on the thread pool
+    Histogram queueWait;
+    // spent acquiring the LockMaster mutexes of its arguments
+    Histogram lockWait;
+    // spent in libgit2
+    Histogram execution;
+    // from the end of its work to the start of its completion on the loop
+    Histogram completionDelay;
+
+    Function(const char *name) : name(name) {}
+  };
+
+  static bool IsEnabled() {
+    return enabled;
+  }
+  static void SetEnabled(bool isEnabled) {
+    enabled = isEnabled;
+  }
+
+  // Returns the stats of the function with the given name, which must be a
+  // string literal. Should be called on the loop thread.
+  static Function *Register(const char *name);
+  static void Reset();
+  static v8::Local<v8::Object> ToJavascript();
+
+private:
+  static bool enabled;
+  static std::vector<Function *> functions;
+};
+
+// Timestamps of one async call, kept by its worker
+class CallTimer {
+  CallStats::Function *function;
+  uint64_t queuedAt;
+  uint64_t startedAt;
+  uint64_t lockedAt;
+  uint64_t executedAt;
+
+public:
+  CallTimer() : function(NULL), queuedAt(0), startedAt(0), lockedAt(0), executedAt(0) {}
+
+  // The call is only timed when queued while stats are enabled
+  void Queued(CallStats::Function *timedFunction) {
+    function = timedFunction;
+    queuedAt = uv_hrtime();
+  }
+
+  void Started() {
+    if (function) {
+      startedAt = uv_hrtime();
+    }
+  }
+
+  void Locked() {
+    if (function) {
+      lockedAt = uv_hrtime();
+    }
+  }
+
+  void Executed() {
+    if (function) {
+      executedAt = uv_hrtime();
+    }
+  }
+
+  void Completed() {
+    if (!function) {
+      return;
+    }
+    uint64_t completedAt = uv_hrtime();
+    function->queueWait.Record(startedAt - queuedAt);
+    function->lockWait.Record(lockedAt - startedAt);
+    function->execution.Record(executedAt - lockedAt);
+    function->completionDelay.Record(completedAt - executedAt);
+    function = NULL;
+  }
+};
+
+#endif
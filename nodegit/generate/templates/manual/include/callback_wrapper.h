@@ -3,10 +3,47 @@
 
 #include <nan.h>
 #include <uv.h>
+#include <git2.h>
+#include <atomic>
+#include <string.h>
+
+#include "async_baton.h"
 
 using namespace v8;
 using namespace node;
 
+// Copies of the arguments of a coalesced callback, which are delivered after
+// the libgit2 call that provided them has returned.
+// Only callbacks marked "coalescable" in callbacks.json are coalesced, and all
+// of their argument types must have an overload here. Copies of libgit2
+// structs are malloc'd, so that the wrapper JS gets can take them over.
+template<typename T>
+inline T CoalescedCopy(T value) {
+  return value;
+}
+
+inline const char *CoalescedCopy(const char *value) {
+  return value == NULL ? NULL : strdup(value);
+}
+
+inline const git_indexer_progress *CoalescedCopy(const git_indexer_progress *value) {
+  git_indexer_progress *copy = (git_indexer_progress *)malloc(sizeof(git_indexer_progress));
+  memcpy(copy, value, sizeof(git_indexer_progress));
+  return copy;
+}
+
+template<typename T>
+inline void CoalescedFree(T value) {
+}
+
+inline void CoalescedFree(const char *value) {
+  free((void *)value);
+}
+
+inline void CoalescedFree(const git_indexer_progress *value) {
+  free((void *)value);
+}
+
 class CallbackWrapper {
   Nan::Callback* jsCallback;
 
@@ -19,15 +56,28 @@ class CallbackWrapper {
   // the default result
   bool waitForResult;
 
+  // true will only keep the latest call while a call is waiting to be
+  // delivered, so at most one call is delivered per loop tick and the last
+  // call is always delivered
+  bool coalesce;
+  // the latest call waiting to be delivered
+  std::atomic<AsyncBaton *> coalescedBaton;
+  // the result of the last delivered call, returned to libgit2 by the
+  // following calls
+  std::atomic<bool> hasCoalescedResult;
+  std::atomic<int> coalescedResult;
+
 public:
-  CallbackWrapper() {
+  CallbackWrapper() : coalescedBaton(NULL), hasCoalescedResult(false), coalescedResult(0) {
     jsCallback = NULL;
     lastCallTime = 0;
     throttle = 0;
+    coalesce = false;
   }
 
   ~CallbackWrapper() {
     SetCallback(NULL);
+    delete TakeCoalesced();
   }
 
   bool HasCallback() {
@@ -38,19 +88,51 @@ public:
     return jsCallback;
   }
 
-  void SetCallback(Nan::Callback* callback, int throttle = 0, bool waitForResult = true) {
+  void SetCallback(Nan::Callback* callback, int throttle = 0, bool waitForResult = true, bool coalesce = false) {
     if(jsCallback) {
       delete jsCallback;
     }
     jsCallback = callback;
     this->throttle = throttle;
     this->waitForResult = waitForResult;
+    this->coalesce = coalesce;
+    hasCoalescedResult = false;
   }
 
   bool ShouldWaitForResult() {
     return waitForResult;
   }
 
+  bool ShouldCoalesce() {
+    return coalesce;
+  }
+
+  // Makes baton the call to deliver next, replacing (and deleting) the call
+  // that was waiting. Returns true if no call was waiting, in which case the
+  // caller has to schedule the delivery.
+  bool StoreCoalesced(AsyncBaton *baton) {
+    AsyncBaton *previousBaton = coalescedBaton.exchange(baton);
+    if (previousBaton == NULL) {
+      return true;
+    }
+    delete previousBaton;
+    return false;
+  }
+
+  // Takes the call to deliver, NULL if it has been taken already
+  AsyncBaton *TakeCoalesced() {
+    return coalescedBaton.exchange(NULL);
+  }
+
+  void SetCoalescedResult(int result) {
+    coalescedResult = result;
+    hasCoalescedResult = true;
+  }
+
+  int GetCoalescedResult(int defaultResult) {
+    return hasCoalescedResult ? coalescedResult.load() : defaultResult;
+  }
+
   bool WillBeThrottled() {
     if(!throttle) {
       return false;
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "async_baton.h"
+#include "object_pool.h"
 #include "promise_completion.h"
 
 extern "C" {
@@ -15,10 +16,15 @@ extern "C" {
 
 struct HunkData {
   git_diff_hunk hunk;
-  std::vector<git_diff_line *> *lines;
+  // the content of every line points into one contiguous buffer holding
+  // the NUL terminated contents of all lines of the hunk
+  std::vector<git_diff_line> *lines;
+  char *content;
+  size_t contentSize;
   size_t numLines;
 };
 
+HunkData *HunkDataDup(const HunkData *hunk);
 void HunkDataFree(HunkData *hunk);
 
 using namespace node;
@@ -51,11 +57,11 @@ class ConvenientHunk : public Nan::ObjectWrap {
     static NAN_METHOD(HeaderLen);
     static NAN_METHOD(Header);
 
-    struct LinesBaton {
+    struct LinesBaton : public PooledObject<LinesBaton> {
       HunkData *hunk;
       std::vector<git_diff_line *> *lines;
     };
-    class LinesWorker : public Nan::AsyncWorker {
+    class LinesWorker : public Nan::AsyncWorker, public PooledObject<LinesWorker> {
       public:
         LinesWorker(
             LinesBaton *_baton,
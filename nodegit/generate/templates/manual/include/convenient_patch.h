@@ -2,9 +2,11 @@
 #define CONVENIENTPATCH_H
 // generated from class_header.h
 #include <nan.h>
+#include <uv.h>
 #include <string>
 
 #include "async_baton.h"
+#include "object_pool.h"
 #include "promise_completion.h"
 
 extern "C" {
@@ -25,11 +27,21 @@ struct PatchData {
   git_delta_t status;
   git_diff_file new_file;
   git_diff_file old_file;
+  // NULL until materialized from raw
   std::vector<HunkData *> *hunks;
   size_t numHunks;
+  // kept until the hunks are materialized, NULL afterwards
+  git_patch *raw;
+  uv_mutex_t hunksMutex;
 };
 
+// Copies the hunks and lines of raw, which the caller still owns
 PatchData *createFromRaw(git_patch *raw);
+// Takes ownership of raw, and copies its hunks and lines the first time
+// they are asked for
+PatchData *createLazyFromRaw(git_patch *raw);
+// Materializes the hunks if needed. May be called from any thread.
+std::vector<HunkData *> *PatchDataGetHunks(PatchData *patch);
 void PatchDataFree(PatchData *patch);
 
 using namespace node;
@@ -63,11 +75,11 @@ class ConvenientPatch : public Nan::ObjectWrap {
     // hunk methods
     static NAN_METHOD(Size);
 
-    struct HunksBaton {
+    struct HunksBaton : public PooledObject<HunksBaton> {
       PatchData *patch;
       std::vector<HunkData *> *hunks;
     };
-    class HunksWorker : public Nan::AsyncWorker {
+    class HunksWorker : public Nan::AsyncWorker, public PooledObject<HunksWorker> {
       public:
         HunksWorker(
             HunksBaton *_baton,
@@ -7,6 +7,7 @@
 
 #include "async_baton.h"
 #include "nodegit_wrapper.h"
+#include "object_pool.h"
 #include "promise_completion.h"
 
 extern "C" {
@@ -33,7 +34,7 @@ class GitFilterRegistry : public Nan::ObjectWrap {
 
     static NAN_METHOD(GitFilterUnregister);
 
-    struct FilterRegisterBaton {
+    struct FilterRegisterBaton : public PooledObject<FilterRegisterBaton> {
       const git_error *error;
       git_filter *filter;
       char *filter_name;
@@ -41,13 +42,13 @@ class GitFilterRegistry : public Nan::ObjectWrap {
       int error_code;
     };
 
-    struct FilterUnregisterBaton {
+    struct FilterUnregisterBaton : public PooledObject<FilterUnregisterBaton> {
       const git_error *error;
       char *filter_name;
       int error_code;
     };
 
-    class RegisterWorker : public Nan::AsyncWorker {
+    class RegisterWorker : public Nan::AsyncWorker, public PooledObject<RegisterWorker> {
       public:
         RegisterWorker(FilterRegisterBaton *_baton, Nan::Callback *callback) 
         : Nan::AsyncWorker(callback), baton(_baton) {};
@@ -59,7 +60,7 @@ class GitFilterRegistry : public Nan::ObjectWrap {
         FilterRegisterBaton *baton;
     };
 
-    class UnregisterWorker : public Nan::AsyncWorker {
+    class UnregisterWorker : public Nan::AsyncWorker, public PooledObject<UnregisterWorker> {
       public:
         UnregisterWorker(FilterUnregisterBaton *_baton, Nan::Callback *callback) 
         : Nan::AsyncWorker(callback), baton(_baton) {};
@@ -13,10 +13,25 @@ public:
     Enabled
   };
 
+  // How a LockMaster locks its objects. Shared locks let many LockMasters
+  // that only read an object hold it at the same time, and are only taken
+  // when read/write locking is enabled. Otherwise every lock is exclusive.
+  enum Mode {
+    Exclusive = 0,
+    Shared
+  };
+
+  // Tags the constructor of LockMasters that must not wait for a lock
+  enum TryLockTag {
+    TryLock
+  };
+
 private:
   static Status status;
+  static bool readWriteLocking;
 
   LockMasterImpl *impl;
+  bool locked;
 
   template<typename T>
   void AddLocks(const T *t) {
@@ -36,22 +51,44 @@ private:
     AddParameters(args...);
   }
 
-  void ConstructorImpl();
+  void ConstructorImpl(Mode mode);
   void DestructorImpl();
   void ObjectToLock(const void *);
-  void ObjectsToLockAdded();
-public:
+  void ObjectsToLockAdded(bool tryLock);
 
-  // we lock on construction
-  template<typename ...Types> LockMaster(bool asyncAction, const Types*... types) {
+  template<typename ...Types> void Construct(Mode mode, bool asyncAction, bool tryLock, const Types*... types) {
+    locked = true;
     if((status == Disabled) || ((status == EnabledForAsyncOnly) && !asyncAction)) {
       impl = NULL;
       return;
     }
 
-    ConstructorImpl();
+    ConstructorImpl(mode);
     AddParameters(types...);
-    ObjectsToLockAdded();
+    ObjectsToLockAdded(tryLock);
+  }
+public:
+
+  // we lock on construction
+  template<typename ...Types> LockMaster(bool asyncAction, const Types*... types) {
+    Construct(Exclusive, asyncAction, false, types...);
+  }
+
+  // used by calls that only read the objects they are passed,
+  // which can then lock them in Shared mode
+  template<typename ...Types> LockMaster(Mode mode, bool asyncAction, const Types*... types) {
+    Construct(mode, asyncAction, false, types...);
+  }
+
+  // used on the JavaScript thread on behalf of async calls, which must not
+  // block: either every object is locked right away, or none is.
+  // IsLocked tells which happened.
+  template<typename ...Types> LockMaster(TryLockTag, Mode mode, const Types*... types) {
+    Construct(mode, true, true, types...);
+  }
+
+  bool IsLocked() const {
+    return locked;
   }
 
   // and unlock on destruction
@@ -104,11 +141,29 @@ public:
     return status;
   }
 
+  // Lets LockMasters created in Shared mode share their locks.
+  // LockMasters that are already locked keep the mode they locked with.
+  static void SetReadWriteLocking(bool enabled) {
+    readWriteLocking = enabled;
+  }
+
+  static bool GetReadWriteLocking() {
+    return readWriteLocking;
+  }
+
   // Diagnostic information that can be provided to the JavaScript layer
   // for a minimal level of testing
   struct Diagnostics {
     // this counts all stored mutexes - even if they are unlocked:
     int storedMutexesCount;
+    // the number of times a LockMaster locked an object's mutex
+    uint64_t lockedMutexesCount;
+    // how many of those locks were taken in Shared mode
+    uint64_t sharedMutexesCount;
+    // the number of times a LockMaster had to wait for an object's mutex
+    uint64_t contendedMutexesCount;
+    // the number of times a LockMaster had to wait to look up an object's mutex
+    uint64_t contendedShardsCount;
   };
 
   static Diagnostics GetDiagnostics();
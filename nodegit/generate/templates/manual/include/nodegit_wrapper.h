@@ -38,6 +38,8 @@ protected:
   Nan::Persistent<v8::Object, Nan::CopyablePersistentTraits<v8::Object> > owner;
 
   static Nan::Persistent<v8::Function> constructor_template;
+  // the template constructor_template was made from, to recognize instances
+  static Nan::Persistent<v8::FunctionTemplate> function_template;
 
   // diagnostic count of self-freeing object instances
   static int SelfFreeingInstanceCount;
@@ -57,6 +59,8 @@ protected:
 
 public:
   static v8::Local<v8::Value> New(const cType *raw, bool selfFreeing, v8::Local<v8::Object> owner = v8::Local<v8::Object>());
+  // Whether value wraps a cType, and so can be unwrapped as a cppClass
+  static bool HasInstance(v8::Local<v8::Value> value);
 
   cType *GetValue();
   void ClearValue();
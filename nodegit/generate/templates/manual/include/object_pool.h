@@ -0,0 +1,98 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <uv.h>
+#include <atomic>
+#include <new>
+#include <stdint.h>
+
+// Counters over the pools of every type, provided to the JavaScript layer
+struct ObjectPoolStats {
+  // objects allocated from the heap because their pool was empty
+  std::atomic<uint64_t> allocatedCount;
+  // objects taken from a pool
+  std::atomic<uint64_t> reusedCount;
+  // objects returned to a pool
+  std::atomic<uint64_t> recycledCount;
+  // objects freed to the heap because their pool was full
+  std::atomic<uint64_t> freedCount;
+};
+
+extern ObjectPoolStats objectPoolStats;
+
+// Memory of destroyed objects of one type, to be used for the next objects
+// of that type. Objects may be allocated and destroyed on any thread.
+class ObjectFreeList {
+  static const int capacity = 64;
+
+  void *objects[capacity];
+  int count;
+  uv_mutex_t mutex;
+
+public:
+  ObjectFreeList() : count(0) {
+    uv_mutex_init(&mutex);
+  }
+
+  // returns NULL if the list is empty
+  void *Pop() {
+    void *object = NULL;
+    uv_mutex_lock(&mutex);
+    if (count > 0) {
+      object = objects[--count];
+    }
+    uv_mutex_unlock(&mutex);
+    return object;
+  }
+
+  // returns false if the list is full
+  bool Push(void *object) {
+    bool pushed = false;
+    uv_mutex_lock(&mutex);
+    if (count < capacity) {
+      objects[count++] = object;
+      pushed = true;
+    }
+    uv_mutex_unlock(&mutex);
+    return pushed;
+  }
+};
+
+// Base class of objects allocated for every async call, such as batons and
+// workers, so that `new` and `delete` recycle their memory instead of going
+// to the heap every time.
+// Derived classes of T have a different size and always use the heap.
+template<typename T>
+class PooledObject {
+  static ObjectFreeList freeList;
+
+public:
+  static void *operator new(size_t size) {
+    if (size == sizeof(T)) {
+      void *object = freeList.Pop();
+      if (object != NULL) {
+        objectPoolStats.reusedCount++;
+        return object;
+      }
+    }
+    objectPoolStats.allocatedCount++;
+    return ::operator new(size);
+  }
+
+  static void operator delete(void *object, size_t size) {
+    if (object == NULL) {
+      return;
+    }
+    if (size == sizeof(T) && freeList.Push(object)) {
+      objectPoolStats.recycledCount++;
+      return;
+    }
+    objectPoolStats.freedCount++;
+    ::operator delete(object);
+  }
+};
+
+template<typename T>
+ObjectFreeList PooledObject<T>::freeList;
+
+#endif
@@ -1,10 +1,9 @@
 #ifndef REFERENCE_COUNTER_H
 #define REFERENCE_COUNTER_H
 
+#include <uv.h>
 #include <unordered_map>
 
-#include "lock_master.h"
-
 // There are certain instances in libgit2 which can be retrieved from multiple sources
 // We need to make sure that we're counting how many times we've seen that pointer
 // so that when we are performing free behavior, we don't free it until it is no longer
@@ -16,7 +15,9 @@
 // GC. We want it to attmept to GC, and if this handle exists, the final repo will not
 // free itself :(.
 //
-// Make sure to utilize LockMaster when incrementing or decrementing a reference count.
+// The counts are spread over shards by the hash of the pointer, each guarded by
+// its own mutex, so counting is thread safe and unrelated pointers rarely wait
+// on each other.
 class ReferenceCounter {
 public:
   static void incrementCountForPointer(void *ptr);
@@ -24,7 +25,24 @@ public:
   static unsigned long decrementCountForPointer(void *ptr);
 
 private:
-  static std::unordered_map<void *, unsigned long> referenceCountByPointer;
+  struct Shard {
+    std::unordered_map<void *, unsigned long> referenceCountByPointer;
+    uv_mutex_t mutex;
+
+    Shard() {
+      uv_mutex_init(&mutex);
+    }
+  };
+
+  static const unsigned shardCount = 16;
+
+  static Shard shards[shardCount];
+
+  static Shard &ShardFor(void *ptr) {
+    // fibonacci hashing spreads the (aligned) addresses over the shards
+    uint32_t hash = (uint32_t)((uintptr_t)ptr >> 3) * 2654435761u;
+    return shards[hash >> 28];
+  }
 };
 
 #endif
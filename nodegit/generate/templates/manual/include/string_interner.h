@@ -0,0 +1,49 @@
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <nan.h>
+#include <string>
+#include <unordered_map>
+
+// Converts the strings of one bulk result, such as the refs of
+// refreshReferences or the commits of commitWalk, to JavaScript strings.
+// Repeated strings (paths, ref names, emails) are only created once, and
+// ASCII strings skip the UTF-8 decoder. Property names go through Key, which
+// looks them up by address instead of hashing them.
+// APIs that hand out wrapped libgit2 objects, such as getReferences and
+// status lists, convert their strings lazily in accessors, one at a time,
+// so there is no bulk result for them to intern.
+// The strings are Locals, so an interner must not outlive the HandleScope
+// it was created in.
+class StringInterner {
+  public:
+    // Strings longer than this are not worth hashing, as they are unlikely
+    // to repeat (commit messages, signatures)
+    static const size_t maxInternedLength = 256;
+
+    StringInterner() : hits(0), misses(0) {}
+
+    v8::Local<v8::String> Intern(const char *str);
+    v8::Local<v8::String> Intern(const char *str, size_t length);
+    // Interns str, or returns null if str is NULL
+    v8::Local<v8::Value> InternOrNull(const char *str);
+    // The property name as an internalized string, created once per
+    // interner. name must be a string literal, as it is looked up by address.
+    v8::Local<v8::String> Key(const char *name);
+
+    // Converts str without interning it
+    static v8::Local<v8::String> New(const char *str);
+    static v8::Local<v8::String> New(const char *str, size_t length);
+    static v8::Local<v8::Value> NewOrNull(const char *str);
+
+    size_t GetHits() const { return hits; }
+    size_t GetMisses() const { return misses; }
+
+  private:
+    std::unordered_map<std::string, v8::Local<v8::String>> strings;
+    std::unordered_map<const char *, v8::Local<v8::String>> keys;
+    size_t hits;
+    size_t misses;
+};
+
+#endif
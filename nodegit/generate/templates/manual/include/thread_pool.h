@@ -2,20 +2,54 @@
 #define THREAD_POOL_H
 
 #include <uv.h>
+#include <atomic>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 class ThreadPool {
 public:
   typedef void (*Callback) (void *);
+  typedef void (*ParallelCallback) (void *, size_t);
+
+  // Work is taken in priority order. Reserved workers only take
+  // Interactive work, so long running Bulk work cannot occupy every worker.
+  enum Priority {
+    Interactive = 0,
+    Bulk,
+    Background
+  };
+  static const int PriorityCount = 3;
+
+  // Per priority statistics that can be provided to the JavaScript layer
+  struct PriorityStats {
+    // work queued but not started yet
+    int queuedCount;
+    // work started since the thread pool was created
+    uint64_t startedCount;
+    // time spent queued, in nanoseconds, summed over startedCount
+    uint64_t totalWaitTime;
+    uint64_t maxWaitTime;
+  };
 
 private:
   struct Work {
     Callback workCallback;
     Callback completionCallback;
     void *data;
+    Priority priority;
+    // the repository the work is on behalf of, if any
+    const void *owner;
+    uint64_t queuedAt;
 
-    Work(Callback workCallback, Callback completionCallback, void *data)
-      : workCallback(workCallback), completionCallback(completionCallback), data(data) {
+    Work()
+      : workCallback(NULL), completionCallback(NULL), data(NULL), priority(Interactive),
+        owner(NULL), queuedAt(0) {
+    }
+
+    Work(Callback workCallback, Callback completionCallback, void *data, Priority priority, const void *owner)
+      : workCallback(workCallback), completionCallback(completionCallback), data(data),
+        priority(priority), owner(owner), queuedAt(uv_hrtime()) {
     }
   };
 
@@ -29,35 +63,248 @@ private:
     }
   };
 
-  // work to be performed on the threadpool
-  std::queue<Work> workQueue;
-  uv_mutex_t workMutex;
-  uv_sem_t workSemaphore;
+  // Bounded lock-free queue of work owned by a single worker.
+  // Any thread may push, and the owning worker as well as idle workers
+  // stealing from it may pop. Each cell carries a sequence number that tells
+  // producers and consumers whether the cell is free, being written or ready.
+  class WorkQueue {
+    struct Cell {
+      std::atomic<size_t> sequence;
+      Work work;
+    };
+
+    Cell *cells;
+    size_t mask;
+    // keep the producer and consumer positions on separate cache lines
+    char enqueuePadding[64];
+    std::atomic<size_t> enqueuePosition;
+    char dequeuePadding[64];
+    std::atomic<size_t> dequeuePosition;
+
+  public:
+    // capacity must be a power of two
+    WorkQueue(size_t capacity = workQueueCapacity);
+    ~WorkQueue();
+
+    // returns false if the queue is full
+    bool Push(const Work &work);
+    // returns false if the queue is empty
+    bool Pop(Work &work);
+    // approximate, only used as scheduling hints
+    bool IsEmpty() const;
+    size_t Size() const;
+  };
+
+  struct Worker {
+    ThreadPool *threadPool;
+    int index;
+    // one queue per priority of work any worker may take
+    WorkQueue workQueues[PriorityCount];
+    // with affinity scheduling, one queue per priority of work whose owner
+    // this is the home worker of. Others only take it when we are saturated.
+    WorkQueue homeQueues[PriorityCount];
+    // signalled by whoever claims this worker while it is idle
+    uv_mutex_t wakeMutex;
+    uv_cond_t wakeCondition;
+    bool wakePending;
+    std::atomic<bool> isIdle;
+    // when the work in progress started, 0 if none
+    std::atomic<uint64_t> busySince;
+    // priority of the work in progress, only touched by the worker
+    Priority workPriority;
+    uv_thread_t thread;
+
+    Worker(ThreadPool *threadPool, int index);
+  };
+
+  // shared by the threads performing the calls of one RunParallel
+  struct ParallelWork {
+    ParallelCallback callback;
+    void *data;
+    size_t count;
+    std::atomic<size_t> nextIndex;
+    // calls that have returned, guarded by mutex
+    size_t doneCount;
+    uv_mutex_t mutex;
+    uv_cond_t doneCondition;
+    // the caller and every helper queued, the last one to let go frees it
+    std::atomic<int> references;
+  };
+
+  static const size_t workQueueCapacity = 1024;
+  static const uint64_t defaultLoopCallbacksBudget = 5 * 1000 * 1000;
+  // with affinity scheduling, a worker is saturated and its work may be
+  // stolen once this much work waits for it, or once its current work has
+  // been running for longer than affinityBusyLimit nanoseconds
+  static const size_t affinityQueueLimit = 4;
+  static const uint64_t affinityBusyLimit = 2 * 1000 * 1000;
+  // shortest time an idle worker waits before looking again at work it
+  // may not steal yet
+  static const uint64_t affinityMinimumWait = 100 * 1000;
+
+  // workers, each with its own queue of work to be performed on the threadpool
+  std::vector<Worker *> workers;
+  int numberOfThreads;
+  bool workersStarted;
+  // round robin cursor used when no worker is idle
+  unsigned nextWorker;
+
+  // the first reservedWorkers workers only take Interactive work
+  std::atomic<int> reservedWorkers;
+
+  // whether work with an owner is queued on the owner's home worker
+  std::atomic<bool> affinityScheduling;
+
+  // work that did not fit in any worker queue, per priority
+  std::queue<Work> overflowQueues[PriorityCount];
+  uv_mutex_t overflowMutex;
+  std::atomic<int> overflowCounts[PriorityCount];
+
+  struct PriorityCounters {
+    std::atomic<int> queuedCount;
+    std::atomic<uint64_t> startedCount;
+    std::atomic<uint64_t> totalWaitTime;
+    std::atomic<uint64_t> maxWaitTime;
+  };
+  PriorityCounters priorityCounters[PriorityCount];
+
+  // priority of work queued on the loop thread, -1 if not set
+  int currentPriority;
+  // priorities of work on behalf of specific owners (repositories),
+  // only touched on the loop thread
+  std::unordered_map<const void *, Priority> ownerPriorities;
+
+  // only touched on the loop thread
   int workInProgressCount;
 
   // completion and async callbacks to be performed on the loop
   std::queue<LoopCallback> loopQueue;
   uv_mutex_t loopMutex;
   uv_async_t loopAsync;
+  // callbacks taken from loopQueue in one batch that have not run yet,
+  // only touched on the loop thread
+  std::queue<LoopCallback> loopBatch;
+  // time in nanoseconds RunLoopCallbacks may spend per tick, 0 for no limit
+  uint64_t loopCallbacksBudget;
+
+  void StartWorkers();
+  bool Serves(Worker *worker, Priority priority) const;
+  // The index of the first worker that serves the priority. All the
+  // workers after it do too.
+  int FirstServingWorker(Priority priority) const;
+  // The worker that work of the owner is queued on with affinity scheduling,
+  // picked among the workers that serve the priority
+  Worker *HomeWorker(const void *owner, Priority priority) const;
+  // Whether other workers may take the work queued on the home queues of
+  // the worker
+  bool IsSaturated(Worker *worker) const;
+  // With affinity scheduling, how long until work queued on the home queue
+  // of another worker may be stolen by the worker, 0 if there is no such work
+  uint64_t TimeUntilStealable(Worker *worker) const;
+  // Finds work for the worker, highest priority first: its own queues, then
+  // the queues of the other workers, then the overflow queue
+  bool TakeWork(Worker *worker, Work &work);
+  bool TakeWork(Worker *worker, Priority priority, Work &work);
+  void RecordStart(const Work &work);
+  // Wakes the worker if it is idle, returns whether it was
+  bool ClaimIdleWorker(Worker *worker);
+  // Waits until the worker is claimed, or for at most timeout nanoseconds
+  // unless it is 0. Returns false if it timed out.
+  bool WaitForClaim(Worker *worker, uint64_t timeout);
+  // Wakes the preferred worker if it is idle, otherwise any idle worker
+  // that takes work of the given priority
+  void WakeIdleWorker(Worker *preferredWorker, Priority priority);
+
+  // the worker running on the current thread, NULL on other threads
+  static thread_local Worker *currentWorker;
 
-  static void RunEventQueue(void *threadPool);
-  void RunEventQueue();
+  // Performs calls of the parallel work until none are left
+  static void RunParallelCalls(ParallelWork *parallelWork);
+  static void RunParallelHelper(void *parallelWork);
+  static void ReleaseParallelWork(ParallelWork *parallelWork);
+
+  static void RunEventQueue(void *worker);
+  void RunEventQueue(Worker *worker);
   static void RunLoopCallbacks(uv_async_t* handle);
   void RunLoopCallbacks();
 
   void QueueLoopCallback(Callback callback, void *data, bool isWork);
 
 public:
-  // Initializes thread pool and spins up the requested number of threads
+  // Initializes thread pool. The requested number of threads is spun up
+  // lazily when the first work is queued.
   // The provided loop will be used for completion callbacks, whenever
   // queued work is completed
   ThreadPool(int numberOfThreads, uv_loop_t *loop);
   // Queues work on the thread pool, followed by completion call scheduled
   // on the loop provided in the constructor.
+  // The owner is the repository the work is on behalf of, if any.
   // QueueWork should be called on the loop provided in the constructor.
-  void QueueWork(Callback workCallback, Callback completionCallback, void *data);
+  void QueueWork(Callback workCallback, Callback completionCallback, void *data,
+    Priority priority = Interactive, const void *owner = NULL);
   // Queues a callback on the loop provided in the constructor
   void ExecuteReverseCallback(Callback reverseCallback, void *data);
+  // Calls callback with every index in [0, count), and returns once all the
+  // calls have returned. Meant for work running on the thread pool: the
+  // calling worker performs calls itself, helped by at most maxThreads - 1
+  // workers that are idle and take work of the same priority, so the pool
+  // never runs more threads than it has. Called from any other thread, all
+  // the calls are performed on that thread.
+  void RunParallel(ParallelCallback callback, void *data, size_t count, int maxThreads);
+
+  // Changes the number of worker threads. Returns false if the workers
+  // have already been started or the number is not positive.
+  // Should be called on the loop provided in the constructor.
+  bool SetNumberOfThreads(int numberOfThreads);
+  int GetNumberOfThreads() const {
+    return numberOfThreads;
+  }
+
+  // Limits the time spent running completion callbacks per loop tick.
+  // Callbacks left over when the budget runs out are run on the next tick.
+  // 0 removes the limit.
+  void SetLoopCallbacksBudget(uint64_t nanoseconds) {
+    loopCallbacksBudget = nanoseconds;
+  }
+  uint64_t GetLoopCallbacksBudget() const {
+    return loopCallbacksBudget;
+  }
+
+  // Changes how many workers only take Interactive work. Returns false if
+  // that would leave no worker for the other priorities.
+  bool SetReservedWorkers(int reservedWorkers);
+  int GetReservedWorkers() const {
+    return reservedWorkers;
+  }
+
+  // With affinity scheduling, work with an owner is queued on a home worker
+  // picked by hashing the owner, so that the caches of a repository stay on
+  // one thread. Other workers only take it when the home worker is saturated:
+  // while work waits behind a busy home worker, an idle worker looks again
+  // once the home worker has been busy for longer than affinityBusyLimit.
+  // Work without an owner, or that did not fit on its home worker, may be
+  // taken by any worker serving its priority right away.
+  void SetAffinityScheduling(bool enabled) {
+    affinityScheduling = enabled;
+  }
+  bool GetAffinityScheduling() const {
+    return affinityScheduling;
+  }
+
+  // The methods below should be called on the loop provided in the constructor.
+
+  // Sets the priority of all work queued until it is cleared with -1,
+  // overriding owner priorities
+  void SetCurrentPriority(int priority) {
+    currentPriority = priority;
+  }
+  bool GetCurrentPriority(Priority &priority) const;
+
+  // Sets the priority of work on behalf of owner, or clears it with -1
+  void SetOwnerPriority(const void *owner, int priority);
+  bool GetOwnerPriority(const void *owner, Priority &priority) const;
+
+  PriorityStats GetPriorityStats(Priority priority) const;
 };
 
 #endif
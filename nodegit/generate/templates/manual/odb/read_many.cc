@@ -0,0 +1,150 @@
+/*
+ * Reads many objects on one worker.
+ * Objects that don't exist are returned as null.
+ * @param Array<Oid|String> oids
+ * @param OdbObject[] callback
+ */
+NAN_METHOD(GitOdb::ReadMany)
+{
+  if (info.Length() == 0 || !info[0]->IsArray()) {
+    return Nan::ThrowError("Array oids is required.");
+  }
+
+  if (info.Length() == 1 || !info[1]->IsFunction()) {
+    return Nan::ThrowError("Callback is required and must be a Function.");
+  }
+
+  v8::Local<v8::Array> oidsArray = v8::Local<v8::Array>::Cast(info[0]);
+  std::vector<git_oid> *oids = new std::vector<git_oid>(oidsArray->Length());
+  for (unsigned int i = 0; i < oidsArray->Length(); i++) {
+    v8::Local<v8::Value> oid = Nan::Get(oidsArray, i).ToLocalChecked();
+    if (oid->IsString()) {
+      Nan::Utf8String oidString(Nan::To<v8::String>(oid).ToLocalChecked());
+      if (git_oid_fromstr(&oids->at(i), *oidString) != GIT_OK) {
+        delete oids;
+        if (git_error_last()) {
+          return Nan::ThrowError(git_error_last()->message);
+        } else {
+          return Nan::ThrowError("Unknown Error");
+        }
+      }
+    } else if (GitOid::HasInstance(oid)) {
+      git_oid_cpy(&oids->at(i), Nan::ObjectWrap::Unwrap<GitOid>(Nan::To<v8::Object>(oid).ToLocalChecked())->GetValue());
+    } else {
+      delete oids;
+      return Nan::ThrowTypeError("Every oid must be an Oid or a String.");
+    }
+  }
+
+  ReadManyBaton* baton = new ReadManyBaton;
+
+  baton->error_code = GIT_OK;
+  baton->error = NULL;
+  baton->odb = Nan::ObjectWrap::Unwrap<GitOdb>(info.This())->GetValue();
+  baton->oids = oids;
+  baton->out = new std::vector<git_odb_object *>;
+  baton->out->reserve(oids->size());
+
+  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[1]));
+  ReadManyWorker *worker = new ReadManyWorker(baton, callback);
+  worker->SaveToPersistent("odb", info.This());
+
+  AsyncLibgit2QueueWorker(worker, baton->odb);
+  return;
+}
+
+void GitOdb::ReadManyWorker::Execute()
+{
+  git_error_clear();
+
+  LockMaster lockMaster(LockMaster::Shared, true, baton->odb);
+
+  for (size_t i = 0; i < baton->oids->size(); i++) {
+    git_odb_object *object = NULL;
+    baton->error_code = git_odb_read(&object, baton->odb, &baton->oids->at(i));
+
+    if (baton->error_code == GIT_ENOTFOUND) {
+      git_error_clear();
+      baton->error_code = GIT_OK;
+    } else if (baton->error_code != GIT_OK) {
+      if (git_error_last() != NULL) {
+        baton->error = git_error_dup(git_error_last());
+      }
+
+      // unwind and return
+      while (baton->out->size()) {
+        git_odb_object *objectToFree = baton->out->back();
+        baton->out->pop_back();
+        git_odb_object_free(objectToFree);
+      }
+
+      delete baton->out;
+      baton->out = NULL;
+      break;
+    }
+
+    baton->out->push_back(object);
+  }
+
+  delete baton->oids;
+  baton->oids = NULL;
+}
+
+void GitOdb::ReadManyWorker::HandleOKCallback()
+{
+  if (baton->out != NULL)
+  {
+    // the objects are owned by the odb, like the ones returned by read
+    v8::Local<v8::Object> odb = Nan::To<v8::Object>(GetFromPersistent("odb")).ToLocalChecked();
+
+    unsigned int size = baton->out->size();
+    Local<Array> result = Nan::New<Array>(size);
+    for (unsigned int i = 0; i < size; i++) {
+      git_odb_object *object = baton->out->at(i);
+      if (object == NULL) {
+        Nan::Set(result, Nan::New<Number>(i), Nan::Null());
+        continue;
+      }
+
+      Nan::Set(result, Nan::New<Number>(i), GitOdbObject::New(object, true, odb));
+    }
+
+    delete baton->out;
+
+    Local<v8::Value> argv[2] = {
+      Nan::Null(),
+      result
+    };
+    callback->Call(2, argv, async_resource);
+  }
+  else if (baton->error)
+  {
+    Local<v8::Object> err = Nan::To<v8::Object>(Nan::Error(baton->error->message)).ToLocalChecked();
+    Nan::Set(err, Nan::New("errno").ToLocalChecked(), Nan::New(baton->error_code));
+    Nan::Set(err, Nan::New("errorFunction").ToLocalChecked(), Nan::New("Odb.readMany").ToLocalChecked());
+    Local<v8::Value> argv[1] = {
+      err
+    };
+    callback->Call(1, argv, async_resource);
+    if (baton->error->message)
+    {
+      free((void *)baton->error->message);
+    }
+
+    free((void *)baton->error);
+  }
+  else if (baton->error_code < 0)
+  {
+    Local<v8::Object> err = Nan::To<v8::Object>(Nan::Error("Odb readMany has thrown an error.")).ToLocalChecked();
+    Nan::Set(err, Nan::New("errno").ToLocalChecked(), Nan::New(baton->error_code));
+    Nan::Set(err, Nan::New("errorFunction").ToLocalChecked(), Nan::New("Odb.readMany").ToLocalChecked());
+    Local<v8::Value> argv[1] = {
+      err
+    };
+    callback->Call(1, argv, async_resource);
+  }
+  else
+  {
+    callback->Call(0, NULL, async_resource);
+  }
+}
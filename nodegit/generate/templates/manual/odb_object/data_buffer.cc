@@ -0,0 +1,36 @@
+// Releases the odb object reference held by a Buffer created by DataBuffer
+// once the Buffer has been garbage collected.
+static void GitOdbObjectDataBufferFree(char *data, void *hint) {
+  git_odb_object_free(static_cast<git_odb_object *>(hint));
+}
+
+/*
+ * Wraps the data of the odb object in a Buffer without copying it.
+ * The Buffer holds its own reference to the odb object, so the data stays
+ * valid until the Buffer is garbage collected, even if the OdbObject is
+ * freed first.
+ * @return Buffer
+ */
+NAN_METHOD(GitOdbObject::DataBuffer) {
+  git_odb_object *object = Nan::ObjectWrap::Unwrap<GitOdbObject>(info.This())->GetValue();
+
+  size_t size = git_odb_object_size(object);
+  // Nan::NewBuffer takes the length as a uint32_t
+  if (size > node::Buffer::kMaxLength || size > UINT32_MAX) {
+    return Nan::ThrowError("Odb object is too large to be wrapped in a Buffer.");
+  }
+
+  git_odb_object *objectReference;
+  if (git_odb_object_dup(&objectReference, object) != GIT_OK) {
+    return Nan::ThrowError("Could not reference the odb object.");
+  }
+
+  info.GetReturnValue().Set(
+    Nan::NewBuffer(
+      (char *)git_odb_object_data(objectReference),
+      (uint32_t)size,
+      GitOdbObjectDataBufferFree,
+      objectReference
+    ).ToLocalChecked()
+  );
+}
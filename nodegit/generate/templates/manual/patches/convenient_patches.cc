@@ -1,27 +1,129 @@
+// Ranges of at least this many deltas are split into slices generated in
+// parallel on the thread pool. Every slice reads its own blobs, the diff
+// itself is only read.
+static const size_t parallelPatchThreshold = 32;
+
+struct ConvenientFromDiffSlice {
+  git_diff *diff;
+  size_t start;
+  size_t end;
+  bool lazy;
+  std::vector<PatchData *> patches;
+  int error_code;
+  const git_error *error;
+
+  static void run(void *data, size_t index) {
+    static_cast<ConvenientFromDiffSlice *>(data)[index].generate();
+  }
+
+  // Builds PatchData for the deltas in [start, end). On failure every
+  // PatchData built so far is freed and the error is kept.
+  void generate() {
+    git_error_clear();
+    error_code = GIT_OK;
+    error = NULL;
+
+    for (size_t i = start; i < end; ++i) {
+      git_patch *nextPatch;
+      int result = git_patch_from_diff(&nextPatch, diff, i);
+
+      if (result) {
+        while (!patches.empty()) {
+          PatchDataFree(patches.back());
+          patches.pop_back();
+        }
+
+        error_code = result;
+
+        if (git_error_last() != NULL) {
+          error = git_error_dup(git_error_last());
+        }
+
+        return;
+      }
+
+      if (nextPatch != NULL && lazy) {
+        patches.push_back(createLazyFromRaw(nextPatch));
+      } else if (nextPatch != NULL) {
+        patches.push_back(createFromRaw(nextPatch));
+        git_patch_free(nextPatch);
+      }
+    }
+  }
+};
+
 NAN_METHOD(GitPatch::ConvenientFromDiff) {
   if (info.Length() == 0 || !info[0]->IsObject()) {
     return Nan::ThrowError("Diff diff is required.");
   }
 
-  if (info.Length() == 1 || !info[1]->IsFunction()) {
+  if (info.Length() == 1 || !info[info.Length() - 1]->IsFunction()) {
     return Nan::ThrowError("Callback is required and must be a Function.");
   }
 
+  git_diff *diff = Nan::ObjectWrap::Unwrap<GitDiff>(Nan::To<v8::Object>(info[0]).ToLocalChecked())->GetValue();
+  size_t numDeltas = git_diff_num_deltas(diff);
+  size_t start = 0;
+  size_t count = numDeltas;
+  int threads = 0;
+  bool lazy = false;
+
+  if (info.Length() > 2 && info[1]->IsObject()) {
+    v8::Local<v8::Object> options = Nan::To<v8::Object>(info[1]).ToLocalChecked();
+
+    v8::Local<v8::Value> startParam = Nan::Get(options, Nan::New("start").ToLocalChecked()).ToLocalChecked();
+    if (!startParam->IsUndefined()) {
+      if (!startParam->IsNumber() || Nan::To<double>(startParam).FromJust() < 0) {
+        return Nan::ThrowError("Start must be a non-negative Number.");
+      }
+      start = (size_t)Nan::To<double>(startParam).FromJust();
+    }
+
+    v8::Local<v8::Value> countParam = Nan::Get(options, Nan::New("count").ToLocalChecked()).ToLocalChecked();
+    if (!countParam->IsUndefined()) {
+      if (!countParam->IsNumber() || Nan::To<double>(countParam).FromJust() < 0) {
+        return Nan::ThrowError("Count must be a non-negative Number.");
+      }
+      count = (size_t)Nan::To<double>(countParam).FromJust();
+    }
+
+    v8::Local<v8::Value> threadsParam = Nan::Get(options, Nan::New("threads").ToLocalChecked()).ToLocalChecked();
+    if (!threadsParam->IsUndefined()) {
+      if (!threadsParam->IsNumber() || Nan::To<int32_t>(threadsParam).FromJust() < 1) {
+        return Nan::ThrowError("Threads must be a Number of at least 1.");
+      }
+      threads = Nan::To<int32_t>(threadsParam).FromJust();
+    }
+
+    lazy = Nan::Get(options, Nan::New("lazy").ToLocalChecked()).ToLocalChecked()->IsTrue();
+  }
+
+  if (start > numDeltas) {
+    start = numDeltas;
+  }
+  if (count > numDeltas - start) {
+    count = numDeltas - start;
+  }
+
   ConvenientFromDiffBaton *baton = new ConvenientFromDiffBaton;
 
   baton->error_code = GIT_OK;
   baton->error = NULL;
 
-  baton->diff = Nan::ObjectWrap::Unwrap<GitDiff>(Nan::To<v8::Object>(info[0]).ToLocalChecked())->GetValue();
+  baton->diff = diff;
+  baton->start = start;
+  baton->count = count;
+  baton->threads = threads;
+  baton->lazy = lazy;
   baton->out = new std::vector<PatchData *>;
-  baton->out->reserve(git_diff_num_deltas(baton->diff));
+  baton->out->reserve(count);
 
-  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[1]));
+  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[info.Length() - 1]));
   ConvenientFromDiffWorker *worker = new ConvenientFromDiffWorker(baton, callback);
 
   worker->SaveToPersistent("diff", info[0]);
 
-  Nan::AsyncQueueWorker(worker);
+  AsyncLibgit2QueueWorker(worker, baton->diff);
   return;
 }
 
@@ -30,46 +132,62 @@ void GitPatch::ConvenientFromDiffWorker::Execute() {
 
   {
     LockMaster lockMaster(true, baton->diff);
-    std::vector<git_patch *> patchesToBeFreed;
-
-    for (int i = 0; i < git_diff_num_deltas(baton->diff); ++i) {
-      git_patch *nextPatch;
-      int result = git_patch_from_diff(&nextPatch, baton->diff, i);
-
-      if (result) {
-        while (!patchesToBeFreed.empty())
-        {
-          git_patch_free(patchesToBeFreed.back());
-          patchesToBeFreed.pop_back();
-        }
-
-        while (!baton->out->empty()) {
-          PatchDataFree(baton->out->back());
-          baton->out->pop_back();
-        }
-
-        baton->error_code = result;
 
-        if (git_error_last() != NULL) {
-          baton->error = git_error_dup(git_error_last());
-        }
+    // without a thread count, use as many threads as the thread pool has,
+    // as long as every slice gets enough deltas to be worth splitting off
+    size_t threadCount = baton->count / parallelPatchThreshold;
+    size_t maxThreadCount = baton->threads > 0
+      ? (size_t)baton->threads
+      : (size_t)libgit2ThreadPool.GetNumberOfThreads();
+    if (threadCount > maxThreadCount) {
+      threadCount = maxThreadCount;
+    }
+    if (threadCount < 1) {
+      threadCount = 1;
+    }
 
-        delete baton->out;
-        baton->out = NULL;
+    // contiguous slices, so the merged results stay in delta order
+    std::vector<ConvenientFromDiffSlice> slices(threadCount);
+    size_t sliceSize = baton->count / threadCount;
+    size_t remainder = baton->count % threadCount;
+    size_t sliceStart = baton->start;
+    for (size_t i = 0; i < threadCount; ++i) {
+      slices[i].diff = baton->diff;
+      slices[i].lazy = baton->lazy;
+      slices[i].start = sliceStart;
+      slices[i].end = sliceStart + sliceSize + (i < remainder ? 1 : 0);
+      sliceStart = slices[i].end;
+    }
 
-        return;
+    // this worker generates slices too, helped by idle workers of the pool
+    libgit2ThreadPool.RunParallel(ConvenientFromDiffSlice::run, slices.data(), threadCount, (int)threadCount);
+
+    // report the error of the first failing delta, and drop everything else
+    for (size_t i = 0; i < threadCount; ++i) {
+      if (slices[i].error_code != GIT_OK && baton->error_code == GIT_OK) {
+        baton->error_code = slices[i].error_code;
+        baton->error = slices[i].error;
+      } else if (slices[i].error != NULL) {
+        free((void *)slices[i].error->message);
+        free((void *)slices[i].error);
       }
+    }
 
-      if (nextPatch != NULL) {
-        baton->out->push_back(createFromRaw(nextPatch));
-        patchesToBeFreed.push_back(nextPatch);
+    for (size_t i = 0; i < threadCount; ++i) {
+      std::vector<PatchData *> &patches = slices[i].patches;
+      if (baton->error_code == GIT_OK) {
+        baton->out->insert(baton->out->end(), patches.begin(), patches.end());
+      } else {
+        while (!patches.empty()) {
+          PatchDataFree(patches.back());
+          patches.pop_back();
+        }
       }
     }
 
-    while (!patchesToBeFreed.empty())
-    {
-      git_patch_free(patchesToBeFreed.back());
-      patchesToBeFreed.pop_back();
+    if (baton->error_code != GIT_OK) {
+      delete baton->out;
+      baton->out = NULL;
     }
   }
 }
@@ -22,7 +22,7 @@ void GitRepository::GetReferencesWorker::Execute()
 {
   giterr_clear();
 
-  LockMaster lockMaster(true, baton->repo);
+  LockMaster lockMaster(LockMaster::Shared, true, baton->repo);
   git_repository *repo = baton->repo;
 
   git_strarray reference_names;
@@ -1,3 +1,6 @@
+#include <list>
+#include <memory>
+
 int getOidOfReferenceCommit(git_oid *commitOid, git_reference *ref) {
   git_object *commitObject;
   int result = git_reference_peel(&commitObject, ref, GIT_OBJ_COMMIT);
@@ -165,38 +168,13 @@ public:
     signatureRegexesBySignatureType.Reset(result);
   }
 
-  v8::Local<v8::Object> toJavascript(v8::Local<v8::String> signatureType) {
+  v8::Local<v8::Object> toJavascript(v8::Local<v8::String> signatureType, StringInterner &strings) {
     v8::Local<v8::Object> result = Nan::New<Object>();
 
-    v8::Local<v8::Value> jsFullName;
-    if (fullName == NULL) {
-      jsFullName = Nan::Null();
-    } else {
-      jsFullName = Nan::New<String>(fullName).ToLocalChecked();
-    }
-    Nan::Set(result, Nan::New("fullName").ToLocalChecked(), jsFullName);
-
-    v8::Local<v8::Value> jsMessage;
-    if (message == NULL) {
-      jsMessage = Nan::Null();
-    } else {
-      jsMessage = Nan::New<String>(message).ToLocalChecked();
-    }
-    Nan::Set(result, Nan::New("message").ToLocalChecked(), jsMessage);
-
-    Nan::Set(
-      result,
-      Nan::New("sha").ToLocalChecked(),
-      Nan::New<String>(sha).ToLocalChecked()
-    );
-
-    v8::Local<v8::Value> jsShorthand;
-    if (shorthand == NULL) {
-      jsShorthand = Nan::Null();
-    } else {
-      jsShorthand = Nan::New<String>(shorthand).ToLocalChecked();
-    }
-    Nan::Set(result, Nan::New("shorthand").ToLocalChecked(), jsShorthand);
+    Nan::Set(result, strings.Key("fullName"), strings.InternOrNull(fullName));
+    Nan::Set(result, strings.Key("message"), StringInterner::NewOrNull(message));
+    Nan::Set(result, strings.Key("sha"), StringInterner::New(sha));
+    Nan::Set(result, strings.Key("shorthand"), strings.InternOrNull(shorthand));
 
     v8::Local<v8::Value> jsTagSignature = Nan::Null();
     if (tagOdbBuffer != NULL && tagOdbBufferLength != 0) {
@@ -224,15 +202,8 @@ public:
         }
       }
     }
-    Nan::Set(result, Nan::New("tagSignature").ToLocalChecked(), jsTagSignature);
-
-    v8::Local<v8::Value> jsType;
-    if (type == NULL) {
-      jsType = Nan::Null();
-    } else {
-      jsType = Nan::New<String>(type).ToLocalChecked();
-    }
-    Nan::Set(result, Nan::New("type").ToLocalChecked(), jsType);
+    Nan::Set(result, strings.Key("tagSignature"), jsTagSignature);
+    Nan::Set(result, strings.Key("type"), strings.InternOrNull(type));
 
     return result;
   }
@@ -308,27 +279,13 @@ public:
     return true;
   }
 
-  v8::Local<v8::Object> toJavascript() {
+  v8::Local<v8::Object> toJavascript(StringInterner &strings) {
     v8::Local<v8::Object> result = Nan::New<Object>();
 
-    v8::Local<v8::Value> jsDownstreamFullName;
-    if (downstreamFullName == NULL) {
-      jsDownstreamFullName = Nan::Null();
-    } else {
-      jsDownstreamFullName = Nan::New<String>(downstreamFullName).ToLocalChecked();
-    }
-    Nan::Set(result, Nan::New("downstreamFullName").ToLocalChecked(), jsDownstreamFullName);
-
-    v8::Local<v8::Value> jsUpstreamFullName;
-    if (upstreamFullName == NULL) {
-      jsUpstreamFullName = Nan::Null();
-    } else {
-      jsUpstreamFullName = Nan::New<String>(upstreamFullName).ToLocalChecked();
-    }
-    Nan::Set(result, Nan::New("upstreamFullName").ToLocalChecked(), jsUpstreamFullName);
-
-    Nan::Set(result, Nan::New("ahead").ToLocalChecked(), Nan::New<Number>(ahead));
-    Nan::Set(result, Nan::New("behind").ToLocalChecked(), Nan::New<Number>(behind));
+    Nan::Set(result, strings.Key("downstreamFullName"), strings.InternOrNull(downstreamFullName));
+    Nan::Set(result, strings.Key("upstreamFullName"), strings.InternOrNull(upstreamFullName));
+    Nan::Set(result, strings.Key("ahead"), Nan::New<Number>(ahead));
+    Nan::Set(result, strings.Key("behind"), Nan::New<Number>(behind));
     return result;
   }
 
@@ -343,12 +300,199 @@ public:
   size_t behind;
 };
 
+// What a refresh saw of each reference, so that the next refresh only has to
+// rebuild the models of references that changed.
+class RefreshReferencesSnapshot {
+public:
+  // full name of each reported reference -> raw oid of its direct target
+  std::unordered_map<std::string, std::string> targets;
+  // full name of each branch with an upstream -> upstream name and raw oids
+  // of both targets
+  std::unordered_map<std::string, std::string> upstreams;
+
+  // Snapshots are kept natively per repository and handed to JavaScript as
+  // ids. Only the most recent ones of the most recently refreshed
+  // repositories are kept. Reading a snapshot leaves it in the store, so a
+  // failed refresh can be retried since the same snapshot.
+  static const size_t maxSnapshots = 8;
+  static const size_t maxRepositories = 32;
+
+  // The snapshot with the id taken of the repository, NULL if the repository
+  // has no such snapshot (anymore)
+  static std::shared_ptr<const RefreshReferencesSnapshot> get(git_repository *repo, unsigned int id) {
+    std::shared_ptr<const RefreshReferencesSnapshot> snapshot;
+    std::string key = repositoryKey(repo);
+    uv_mutex_lock(&storeMutex);
+    for (auto repository = store.begin(); repository != store.end(); ++repository) {
+      if (repository->first != key) {
+        continue;
+      }
+      for (auto it = repository->second.begin(); it != repository->second.end(); ++it) {
+        if (it->first == id) {
+          snapshot = it->second;
+          break;
+        }
+      }
+      break;
+    }
+    uv_mutex_unlock(&storeMutex);
+    return snapshot;
+  }
+
+  static unsigned int put(git_repository *repo, RefreshReferencesSnapshot *snapshot) {
+    std::string key = repositoryKey(repo);
+    uv_mutex_lock(&storeMutex);
+    unsigned int id = ++lastId;
+
+    auto repository = store.begin();
+    while (repository != store.end() && repository->first != key) {
+      ++repository;
+    }
+    if (repository == store.end()) {
+      store.push_front(std::make_pair(key, Snapshots()));
+      if (store.size() > maxRepositories) {
+        store.pop_back();
+      }
+    } else {
+      store.splice(store.begin(), store, repository);
+    }
+
+    Snapshots &snapshots = store.front().second;
+    snapshots.push_front(std::make_pair(id, std::shared_ptr<const RefreshReferencesSnapshot>(snapshot)));
+    if (snapshots.size() > maxSnapshots) {
+      snapshots.pop_back();
+    }
+    uv_mutex_unlock(&storeMutex);
+    return id;
+  }
+
+  static std::string rawOid(const git_oid *oid) {
+    return oid == NULL
+      ? std::string(GIT_OID_RAWSZ, '\0')
+      : std::string((const char *)oid->id, GIT_OID_RAWSZ);
+  }
+
+  // the upstream key of a branch, empty if it has no upstream
+  static std::string upstreamKey(git_reference *ref) {
+    if (!git_reference_is_branch(ref)) {
+      return std::string();
+    }
+
+    git_reference *upstream;
+    if (git_branch_upstream(&upstream, ref) != GIT_OK) {
+      giterr_clear();
+      return std::string();
+    }
+
+    std::string key(git_reference_name(upstream));
+    key.push_back('\0');
+    key.append(rawOid(git_reference_target(ref)));
+    key.append(rawOid(git_reference_target(upstream)));
+    git_reference_free(upstream);
+    return key;
+  }
+
+private:
+  // most recent first
+  typedef std::list<std::pair<unsigned int, std::shared_ptr<const RefreshReferencesSnapshot> > > Snapshots;
+
+  // Repositories are told apart by their git directory, as the address of a
+  // freed repository may be reused by another one
+  static std::string repositoryKey(git_repository *repo) {
+    const char *path = git_repository_path(repo);
+    if (path != NULL) {
+      return std::string(path);
+    }
+
+    std::ostringstream address;
+    address << (const void *)repo;
+    return address.str();
+  }
+
+  // most recently refreshed first
+  static std::list<std::pair<std::string, Snapshots> > store;
+  static unsigned int lastId;
+  static uv_mutex_t storeMutex;
+  static int storeMutexInitialized;
+};
+
+const size_t RefreshReferencesSnapshot::maxSnapshots;
+const size_t RefreshReferencesSnapshot::maxRepositories;
+std::list<std::pair<std::string, RefreshReferencesSnapshot::Snapshots> > RefreshReferencesSnapshot::store;
+unsigned int RefreshReferencesSnapshot::lastId = 0;
+uv_mutex_t RefreshReferencesSnapshot::storeMutex;
+int RefreshReferencesSnapshot::storeMutexInitialized = uv_mutex_init(&RefreshReferencesSnapshot::storeMutex);
+
+// A reference whose model and/or upstream info has to be rebuilt
+struct RefreshReferencesWorkItem {
+  const char *fullName;
+  bool refreshModel;
+  bool refreshUpstream;
+  RefreshedRefModel *model;
+  UpstreamModel *upstream;
+};
+
+// Rebuilds every step-th work item starting at start
+void refreshReferencesWorkItems(
+  git_repository *repo,
+  git_odb *odb,
+  std::vector<RefreshReferencesWorkItem> &workItems,
+  size_t start,
+  size_t step
+) {
+  for (size_t i = start; i < workItems.size(); i += step) {
+    RefreshReferencesWorkItem &workItem = workItems[i];
+    git_reference *reference;
+    if (lookupDirectReferenceByFullName(&reference, repo, workItem.fullName) != GIT_OK || reference == NULL) {
+      giterr_clear();
+      continue;
+    }
+
+    if (workItem.refreshUpstream && !UpstreamModel::fromReference(&workItem.upstream, reference)) {
+      workItem.upstream = NULL;
+    }
+
+    if (workItem.refreshModel && RefreshedRefModel::fromReference(&workItem.model, reference, odb) != GIT_OK) {
+      workItem.model = NULL;
+    }
+    giterr_clear();
+
+    git_reference_free(reference);
+  }
+}
+
+// Work items are rebuilt in parallel on the thread pool once there are this
+// many of them. The workers share the repository, looking up references and
+// reading objects are safe to do concurrently.
+static const size_t parallelRefreshThreshold = 256;
+
+struct RefreshReferencesParallelWork {
+  git_repository *repo;
+  git_odb *odb;
+  std::vector<RefreshReferencesWorkItem> *workItems;
+  size_t step;
+
+  static void run(void *data, size_t start) {
+    RefreshReferencesParallelWork *parallelWork = static_cast<RefreshReferencesParallelWork *>(data);
+    refreshReferencesWorkItems(
+      parallelWork->repo,
+      parallelWork->odb,
+      *parallelWork->workItems,
+      start,
+      parallelWork->step
+    );
+  }
+};
+
 class RefreshReferencesData {
 public:
   RefreshReferencesData():
     headRefFullName(NULL),
     cherrypick(NULL),
-    merge(NULL) {}
+    merge(NULL),
+    isIncremental(false),
+    hasSnapshot(false),
+    snapshotId(0) {}
 
   ~RefreshReferencesData() {
     while(refs.size()) {
@@ -369,26 +513,51 @@ public:
   char *headRefFullName;
   RefreshedRefModel *cherrypick;
   RefreshedRefModel *merge;
+  // only set for incremental refreshes
+  std::vector<std::string> removedRefs;
+  std::vector<std::string> removedUpstreams;
+  bool isIncremental;
+  bool hasSnapshot;
+  unsigned int snapshotId;
 };
 
 NAN_METHOD(GitRepository::RefreshReferences)
 {
-  v8::Local<v8::String> signatureType;
+  v8::Local<v8::String> signatureType = Nan::New("gpgsig").ToLocalChecked();
+  bool incremental = false;
+  unsigned int since = 0;
   if (info.Length() == 2) {
-    if (!info[0]->IsString()) {
+    v8::Local<v8::Value> signatureTypeParam = info[0];
+    if (info[0]->IsObject()) {
+      v8::Local<v8::Object> options = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+      signatureTypeParam = Nan::Get(options, Nan::New("signatureType").ToLocalChecked()).ToLocalChecked();
+      if (signatureTypeParam->IsUndefined()) {
+        signatureTypeParam = signatureType;
+      }
+
+      incremental = Nan::Get(options, Nan::New("incremental").ToLocalChecked()).ToLocalChecked()->IsTrue();
+
+      v8::Local<v8::Value> sinceParam = Nan::Get(options, Nan::New("since").ToLocalChecked()).ToLocalChecked();
+      if (!sinceParam->IsNull() && !sinceParam->IsUndefined()) {
+        if (!sinceParam->IsNumber()) {
+          return Nan::ThrowError("Since must be the snapshot of a previous incremental refresh.");
+        }
+        since = Nan::To<uint32_t>(sinceParam).FromJust();
+      }
+    }
+
+    if (!signatureTypeParam->IsString()) {
       return Nan::ThrowError("Signature type must be \"gpgsig\" or \"x509\".");
     }
 
-    v8::Local<v8::String> signatureTypeParam = Nan::To<v8::String>(info[0]).ToLocalChecked();
+    v8::Local<v8::String> signatureTypeString = Nan::To<v8::String>(signatureTypeParam).ToLocalChecked();
     if (
-      Nan::Equals(signatureTypeParam, Nan::New("gpgsig").ToLocalChecked()) != Nan::Just(true)
-      && Nan::Equals(signatureTypeParam, Nan::New("x509").ToLocalChecked()) != Nan::Just(true)
+      Nan::Equals(signatureTypeString, Nan::New("gpgsig").ToLocalChecked()) != Nan::Just(true)
+      && Nan::Equals(signatureTypeString, Nan::New("x509").ToLocalChecked()) != Nan::Just(true)
     ) {
       return Nan::ThrowError("Signature type must be \"gpgsig\" or \"x509\".");
     }
-    signatureType = signatureTypeParam;
-  } else {
-    signatureType = Nan::New("gpgsig").ToLocalChecked();
+    signatureType = signatureTypeString;
   }
 
   if (info.Length() == 0 || (info.Length() == 1 && !info[0]->IsFunction()) || (info.Length() == 2 && !info[1]->IsFunction())) {
@@ -399,14 +568,16 @@ NAN_METHOD(GitRepository::RefreshReferences)
 
   baton->error_code = GIT_OK;
   baton->error = NULL;
+  baton->incremental = incremental;
+  baton->since = since;
   baton->out = (void *)new RefreshReferencesData;
   baton->repo = Nan::ObjectWrap::Unwrap<GitRepository>(info.This())->GetValue();
 
-  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[0]));
+  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[info.Length() - 1]));
   RefreshReferencesWorker *worker = new RefreshReferencesWorker(baton, callback);
   worker->SaveToPersistent("repo", info.This());
   worker->SaveToPersistent("signatureType", signatureType);
-  Nan::AsyncQueueWorker(worker);
+  AsyncLibgit2QueueWorker(worker, baton->repo);
   return;
 }
 
@@ -414,16 +585,37 @@ void GitRepository::RefreshReferencesWorker::Execute()
 {
   giterr_clear();
 
-  LockMaster lockMaster(true, baton->repo);
+  LockMaster lockMaster(LockMaster::Shared, true, baton->repo);
   git_repository *repo = baton->repo;
   RefreshReferencesData *refreshData = (RefreshReferencesData *)baton->out;
   git_odb *odb;
 
+  // the snapshot to compare with, empty for a full refresh
+  std::shared_ptr<const RefreshReferencesSnapshot> previousSnapshot;
+  if (baton->incremental && baton->since != 0) {
+    previousSnapshot = RefreshReferencesSnapshot::get(repo, baton->since);
+    if (!previousSnapshot) {
+      giterr_set_str(GITERR_REFERENCE, "Since is not a snapshot of this repository, or it has been dropped.");
+      baton->error_code = GIT_ENOTFOUND;
+      baton->error = git_error_dup(giterr_last());
+      delete refreshData;
+      baton->out = NULL;
+      return;
+    }
+  }
+  refreshData->isIncremental = (bool)previousSnapshot;
+
+  RefreshReferencesSnapshot *snapshot = NULL;
+  if (baton->incremental) {
+    snapshot = new RefreshReferencesSnapshot;
+  }
+
   baton->error_code = git_repository_odb(&odb, repo);
   if (baton->error_code != GIT_OK) {
     if (giterr_last() != NULL) {
       baton->error = git_error_dup(giterr_last());
     }
+    delete snapshot;
     delete refreshData;
     baton->out = NULL;
     return;
@@ -438,6 +630,7 @@ void GitRepository::RefreshReferencesWorker::Execute()
       baton->error = git_error_dup(giterr_last());
     }
     git_odb_free(odb);
+    delete snapshot;
     delete refreshData;
     baton->out = NULL;
     return;
@@ -451,13 +644,28 @@ void GitRepository::RefreshReferencesWorker::Execute()
     }
     git_odb_free(odb);
     git_reference_free(headRef);
+    delete snapshot;
     delete refreshData;
     baton->out = NULL;
     return;
   }
-  refreshData->refs.push_back(headModel);
 
   refreshData->headRefFullName = strdup(git_reference_name(headRef));
+  if (snapshot != NULL) {
+    std::string target = RefreshReferencesSnapshot::rawOid(git_reference_target(headRef));
+    snapshot->targets[refreshData->headRefFullName] = target;
+
+    if (previousSnapshot) {
+      auto previousTarget = previousSnapshot->targets.find(refreshData->headRefFullName);
+      if (previousTarget != previousSnapshot->targets.end() && previousTarget->second == target) {
+        delete headModel;
+        headModel = NULL;
+      }
+    }
+  }
+  if (headModel != NULL) {
+    refreshData->refs.push_back(headModel);
+  }
   git_reference_free(headRef);
   // END Refresh HEAD
 
@@ -487,6 +695,7 @@ void GitRepository::RefreshReferencesWorker::Execute()
       baton->error = git_error_dup(giterr_last());
     }
     git_odb_free(odb);
+    delete snapshot;
     delete refreshData;
     baton->out = NULL;
     return;
@@ -501,6 +710,7 @@ void GitRepository::RefreshReferencesWorker::Execute()
       baton->error = git_error_dup(giterr_last());
     }
     git_odb_free(odb);
+    delete snapshot;
     delete refreshData;
     baton->out = NULL;
     return;
@@ -515,14 +725,19 @@ void GitRepository::RefreshReferencesWorker::Execute()
     }
     git_odb_free(odb);
     git_strarray_free(&referenceNames);
+    delete snapshot;
     delete refreshData;
     baton->out = NULL;
     return;
   }
 
+  // Only looks up and filters the references here, building the models is
+  // left to refreshReferencesWorkItems, for the references that changed.
+  std::vector<RefreshReferencesWorkItem> workItems;
   for (size_t referenceIndex = 0; referenceIndex < referenceNames.count; ++referenceIndex) {
+    const char *fullName = referenceNames.strings[referenceIndex];
     git_reference *reference;
-    baton->error_code = lookupDirectReferenceByFullName(&reference, repo, referenceNames.strings[referenceIndex]);
+    baton->error_code = lookupDirectReferenceByFullName(&reference, repo, fullName);
 
     if (baton->error_code != GIT_OK) {
       break;
@@ -532,40 +747,85 @@ void GitRepository::RefreshReferencesWorker::Execute()
       continue;
     }
 
-    UpstreamModel *upstreamModel;
-    if (UpstreamModel::fromReference(&upstreamModel, reference)) {
-      refreshData->upstreamInfo.push_back(upstreamModel);
+    RefreshReferencesWorkItem workItem = { fullName, false, false, NULL, NULL };
+
+    if (snapshot == NULL) {
+      workItem.refreshUpstream = git_reference_is_branch(reference);
+    } else {
+      std::string upstreamKey = RefreshReferencesSnapshot::upstreamKey(reference);
+      if (!upstreamKey.empty()) {
+        snapshot->upstreams[fullName] = upstreamKey;
+        workItem.refreshUpstream = true;
+        if (previousSnapshot) {
+          auto previousUpstreamKey = previousSnapshot->upstreams.find(fullName);
+          workItem.refreshUpstream = previousUpstreamKey == previousSnapshot->upstreams.end()
+            || previousUpstreamKey->second != upstreamKey;
+        }
+      }
     }
 
     bool isBranch = git_reference_is_branch(reference);
     bool isRemote = git_reference_is_remote(reference);
     bool isTag = git_reference_is_tag(reference);
+    bool isReported = true;
     if (
-      strcmp(referenceNames.strings[referenceIndex], headModel->fullName) == 0
+      strcmp(fullName, refreshData->headRefFullName) == 0
       || (!isBranch && !isRemote && !isTag)
     ) {
-      git_reference_free(reference);
-      continue;
+      isReported = false;
     }
 
-    if (isRemote) {
+    if (isReported && isRemote) {
       char *remoteNameOfRef = getRemoteNameOfReference(reference);
-      bool isFromExistingRemote = gitStrArrayContains(&remoteNames, remoteNameOfRef);
+      isReported = gitStrArrayContains(&remoteNames, remoteNameOfRef);
       delete[] remoteNameOfRef;
-      if (!isFromExistingRemote) {
-        git_reference_free(reference);
-        continue;
-      }
     }
 
-    RefreshedRefModel *refreshedRefModel;
-    baton->error_code = RefreshedRefModel::fromReference(&refreshedRefModel, reference, odb);
+    if (isReported) {
+      workItem.refreshModel = true;
+      if (snapshot != NULL) {
+        std::string target = RefreshReferencesSnapshot::rawOid(git_reference_target(reference));
+        snapshot->targets[fullName] = target;
+
+        if (previousSnapshot) {
+          auto previousTarget = previousSnapshot->targets.find(fullName);
+          workItem.refreshModel = previousTarget == previousSnapshot->targets.end()
+            || previousTarget->second != target;
+        }
+      }
+    }
     git_reference_free(reference);
 
-    if (baton->error_code == GIT_OK) {
-      refreshData->refs.push_back(refreshedRefModel);
+    if (workItem.refreshModel || workItem.refreshUpstream) {
+      workItems.push_back(workItem);
+    }
+  }
+
+  if (baton->error_code == GIT_OK) {
+    size_t threadCount = workItems.size() / parallelRefreshThreshold;
+    if (threadCount > (size_t)libgit2ThreadPool.GetNumberOfThreads()) {
+      threadCount = libgit2ThreadPool.GetNumberOfThreads();
+    }
+    if (threadCount > 1) {
+      RefreshReferencesParallelWork parallelWork = { repo, odb, &workItems, threadCount };
+      libgit2ThreadPool.RunParallel(RefreshReferencesParallelWork::run, &parallelWork, threadCount, (int)threadCount);
     } else {
-      baton->error_code = GIT_OK;
+      refreshReferencesWorkItems(repo, odb, workItems, 0, 1);
+    }
+
+    // keep the order of the reference list
+    for (size_t i = 0; i < workItems.size(); ++i) {
+      if (workItems[i].upstream != NULL) {
+        refreshData->upstreamInfo.push_back(workItems[i].upstream);
+      }
+      if (workItems[i].model != NULL) {
+        refreshData->refs.push_back(workItems[i].model);
+      }
+    }
+  } else {
+    for (size_t i = 0; i < workItems.size(); ++i) {
+      delete workItems[i].upstream;
+      delete workItems[i].model;
     }
   }
 
@@ -577,10 +837,29 @@ void GitRepository::RefreshReferencesWorker::Execute()
     if (giterr_last() != NULL) {
       baton->error = git_error_dup(giterr_last());
     }
+    delete snapshot;
     delete refreshData;
     baton->out = NULL;
     return;
   }
+
+  if (previousSnapshot) {
+    for (auto it = previousSnapshot->targets.begin(); it != previousSnapshot->targets.end(); ++it) {
+      if (snapshot->targets.find(it->first) == snapshot->targets.end()) {
+        refreshData->removedRefs.push_back(it->first);
+      }
+    }
+    for (auto it = previousSnapshot->upstreams.begin(); it != previousSnapshot->upstreams.end(); ++it) {
+      if (snapshot->upstreams.find(it->first) == snapshot->upstreams.end()) {
+        refreshData->removedUpstreams.push_back(it->first);
+      }
+    }
+  }
+
+  if (snapshot != NULL) {
+    refreshData->hasSnapshot = true;
+    refreshData->snapshotId = RefreshReferencesSnapshot::put(repo, snapshot);
+  }
 }
 
 void GitRepository::RefreshReferencesWorker::HandleOKCallback()
@@ -590,6 +869,8 @@ void GitRepository::RefreshReferencesWorker::HandleOKCallback()
     RefreshedRefModel::ensureSignatureRegexes();
     RefreshReferencesData *refreshData = (RefreshReferencesData *)baton->out;
     v8::Local<v8::Object> result = Nan::New<Object>();
+    // ref names and property names repeat between refs and upstream info
+    StringInterner strings;
 
     Nan::Set(
       result,
@@ -603,7 +884,7 @@ void GitRepository::RefreshReferencesWorker::HandleOKCallback()
     v8::Local<v8::Array> refs = Nan::New<v8::Array>(numRefs);
     for (unsigned int i = 0; i < numRefs; ++i) {
       RefreshedRefModel *refreshedRefModel = refreshData->refs[i];
-      Nan::Set(refs, Nan::New(i), refreshedRefModel->toJavascript(signatureType));
+      Nan::Set(refs, Nan::New(i), refreshedRefModel->toJavascript(signatureType, strings));
     }
     Nan::Set(result, Nan::New("refs").ToLocalChecked(), refs);
 
@@ -611,7 +892,7 @@ void GitRepository::RefreshReferencesWorker::HandleOKCallback()
     v8::Local<v8::Array> upstreamInfo = Nan::New<v8::Array>(numUpstreamInfo);
     for (unsigned int i = 0; i < numUpstreamInfo; ++i) {
       UpstreamModel *upstreamModel = refreshData->upstreamInfo[i];
-      Nan::Set(upstreamInfo, Nan::New(i), upstreamModel->toJavascript());
+      Nan::Set(upstreamInfo, Nan::New(i), upstreamModel->toJavascript(strings));
     }
     Nan::Set(result, Nan::New("upstreamInfo").ToLocalChecked(), upstreamInfo);
 
@@ -619,7 +900,7 @@ void GitRepository::RefreshReferencesWorker::HandleOKCallback()
       Nan::Set(
         result,
         Nan::New("cherrypick").ToLocalChecked(),
-        refreshData->cherrypick->toJavascript(signatureType)
+        refreshData->cherrypick->toJavascript(signatureType, strings)
       );
     } else {
       Nan::Set(result, Nan::New("cherrypick").ToLocalChecked(), Nan::Null());
@@ -629,12 +910,32 @@ void GitRepository::RefreshReferencesWorker::HandleOKCallback()
       Nan::Set(
         result,
         Nan::New("merge").ToLocalChecked(),
-        refreshData->merge->toJavascript(signatureType)
+        refreshData->merge->toJavascript(signatureType, strings)
       );
     } else {
       Nan::Set(result, Nan::New("merge").ToLocalChecked(), Nan::Null());
     }
 
+    Nan::Set(result, Nan::New("isIncremental").ToLocalChecked(), Nan::New(refreshData->isIncremental));
+
+    unsigned int numRemovedRefs = refreshData->removedRefs.size();
+    v8::Local<v8::Array> removedRefs = Nan::New<v8::Array>(numRemovedRefs);
+    for (unsigned int i = 0; i < numRemovedRefs; ++i) {
+      Nan::Set(removedRefs, Nan::New(i), StringInterner::New(refreshData->removedRefs[i].c_str(), refreshData->removedRefs[i].size()));
+    }
+    Nan::Set(result, Nan::New("removedRefs").ToLocalChecked(), removedRefs);
+
+    unsigned int numRemovedUpstreams = refreshData->removedUpstreams.size();
+    v8::Local<v8::Array> removedUpstreamInfo = Nan::New<v8::Array>(numRemovedUpstreams);
+    for (unsigned int i = 0; i < numRemovedUpstreams; ++i) {
+      Nan::Set(removedUpstreamInfo, Nan::New(i), StringInterner::New(refreshData->removedUpstreams[i].c_str(), refreshData->removedUpstreams[i].size()));
+    }
+    Nan::Set(result, Nan::New("removedUpstreamInfo").ToLocalChecked(), removedUpstreamInfo);
+
+    if (refreshData->hasSnapshot) {
+      Nan::Set(result, Nan::New("snapshot").ToLocalChecked(), Nan::New(refreshData->snapshotId));
+    }
+
     delete refreshData;
 
     Local<v8::Value> argv[2] = {
@@ -1,13 +1,13 @@
-#define SET_ON_OBJECT(obj, field, data) Nan::Set(obj, Nan::New(field).ToLocalChecked(), data)
+#define SET_ON_OBJECT(obj, field, data) Nan::Set(obj, strings.Key(field), data)
 
-v8::Local<v8::Object> signatureToJavascript(const git_signature *signature) {
+v8::Local<v8::Object> signatureToJavascript(const git_signature *signature, StringInterner &strings) {
   v8::Local<v8::Object> signatureObject = Nan::New<v8::Object>();
-  SET_ON_OBJECT(signatureObject, "name", Nan::New(signature->name).ToLocalChecked());
-  SET_ON_OBJECT(signatureObject, "email", Nan::New(signature->email).ToLocalChecked());
+  SET_ON_OBJECT(signatureObject, "name", strings.Intern(signature->name));
+  SET_ON_OBJECT(signatureObject, "email", strings.Intern(signature->email));
   SET_ON_OBJECT(signatureObject, "date", Nan::New<v8::Number>(signature->when.time * 1000));
   std::stringstream fullSignature;
-  fullSignature << signature->name << " <" << signature << ">";
-  SET_ON_OBJECT(signatureObject, "full", Nan::New(fullSignature.str()).ToLocalChecked());
+  fullSignature << signature->name << " <" << signature->email << ">";
+  SET_ON_OBJECT(signatureObject, "full", strings.Intern(fullSignature.str().c_str()));
   return signatureObject;
 }
 
@@ -40,7 +40,7 @@ public:
     }
   }
 
-  v8::Local<v8::Value> toJavascript() {
+  v8::Local<v8::Value> toJavascript(StringInterner &strings) {
     if (!fetchSignature) {
       v8::Local<v8::Value> commitObject = GitCommit::New(
         commit,
@@ -55,28 +55,29 @@ public:
     }
 
     v8::Local<v8::Object> commitModel = Nan::New<v8::Object>();
-    SET_ON_OBJECT(commitModel, "sha", Nan::New(git_oid_tostr_s(git_commit_id(commit))).ToLocalChecked());
-    SET_ON_OBJECT(commitModel, "message", Nan::New(git_commit_message(commit)).ToLocalChecked());
-    SET_ON_OBJECT(commitModel, "author", signatureToJavascript(git_commit_author(commit)));
-    SET_ON_OBJECT(commitModel, "committer", signatureToJavascript(git_commit_committer(commit)));
+    // the sha of a commit is usually the parent of the previous one
+    SET_ON_OBJECT(commitModel, "sha", strings.Intern(git_oid_tostr_s(git_commit_id(commit))));
+    SET_ON_OBJECT(commitModel, "message", StringInterner::New(git_commit_message(commit)));
+    SET_ON_OBJECT(commitModel, "author", signatureToJavascript(git_commit_author(commit), strings));
+    SET_ON_OBJECT(commitModel, "committer", signatureToJavascript(git_commit_committer(commit), strings));
 
     size_t parentCount = parentIds.size();
     v8::Local<v8::Array> parents = Nan::New<v8::Array>(parentCount);
     for (size_t parentIndex = 0; parentIndex < parentCount; ++parentIndex) {
-      Nan::Set(parents, Nan::New<v8::Number>(parentIndex), Nan::New(parentIds[parentIndex]).ToLocalChecked());
+      Nan::Set(parents, Nan::New<v8::Number>(parentIndex), strings.Intern(parentIds[parentIndex].c_str(), parentIds[parentIndex].size()));
     }
     SET_ON_OBJECT(commitModel, "parents", parents);
 
     if (signature.size != 0 || signedData.size != 0) {
       v8::Local<v8::Object> gpgSignature = Nan::New<v8::Object>();
       if (signature.size != 0) {
-        SET_ON_OBJECT(gpgSignature, "signature", Nan::New(signature.ptr).ToLocalChecked());
+        SET_ON_OBJECT(gpgSignature, "signature", StringInterner::New(signature.ptr, signature.size));
       } else {
         SET_ON_OBJECT(gpgSignature, "signature", Nan::Null());
       }
 
       if (signedData.size != 0) {
-        SET_ON_OBJECT(gpgSignature, "signedData", Nan::New(signedData.ptr).ToLocalChecked());
+        SET_ON_OBJECT(gpgSignature, "signedData", StringInterner::New(signedData.ptr, signedData.size));
       } else {
         SET_ON_OBJECT(gpgSignature, "signedData", Nan::Null());
       }
@@ -145,7 +146,7 @@ NAN_METHOD(GitRevwalk::CommitWalk) {
   CommitWalkWorker *worker = new CommitWalkWorker(baton, callback);
   worker->SaveToPersistent("commitWalk", info.This());
 
-  Nan::AsyncQueueWorker(worker);
+  AsyncLibgit2QueueWorker(worker, baton->walk);
   return;
 }
 
@@ -206,12 +207,13 @@ void GitRevwalk::CommitWalkWorker::HandleOKCallback() {
     std::vector<CommitModel *> *out = static_cast<std::vector<CommitModel *> *>(baton->out);
     const unsigned int size = out->size();
     Local<Array> result = Nan::New<Array>(size);
+    StringInterner strings;
     for (unsigned int i = 0; i < size; i++) {
       CommitModel *commitModel = out->at(i);
       Nan::Set(
         result,
         Nan::New<Number>(i),
-        commitModel->toJavascript()
+        commitModel->toJavascript(strings)
       );
       delete commitModel;
     }
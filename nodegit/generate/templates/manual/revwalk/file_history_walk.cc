@@ -1,3 +1,6 @@
+#include <list>
+#include <unordered_set>
+
 // Note: commit is not owned by this class (must be freed elsewhere)
 class FileHistoryEvent {
 public:
@@ -26,9 +29,11 @@ public:
     if (commit != NULL) {
       git_commit_free(commit);
     }
+    free((void *)from);
+    free((void *)to);
   }
 
-  v8::Local<v8::Value> toJavascript() {
+  v8::Local<v8::Value> toJavascript(StringInterner &strings) {
     v8::Local<v8::Object> historyEntry = Nan::New<v8::Object>();
     v8::Local<v8::Array> owners = Nan::New<Array>(1);
     Nan::Set(
@@ -39,16 +44,16 @@ public:
         true
       )).ToLocalChecked()
     );
-    Nan::Set(historyEntry, Nan::New("commit").ToLocalChecked(), GitCommit::New(commit, true, owners));
+    Nan::Set(historyEntry, strings.Key("commit"), GitCommit::New(commit, true, owners));
     commit = NULL;
-    Nan::Set(historyEntry, Nan::New("status").ToLocalChecked(), Nan::New<Number>(type));
-    Nan::Set(historyEntry, Nan::New("isMergeCommit").ToLocalChecked(), Nan::New(isMergeCommit));
+    Nan::Set(historyEntry, strings.Key("status"), Nan::New<Number>(type));
+    Nan::Set(historyEntry, strings.Key("isMergeCommit"), Nan::New(isMergeCommit));
     if (type == GIT_DELTA_RENAMED) {
       if (from != NULL) {
-        Nan::Set(historyEntry, Nan::New("oldName").ToLocalChecked(), Nan::New(from).ToLocalChecked());
+        Nan::Set(historyEntry, strings.Key("oldName"), strings.Intern(from));
       }
       if (to != NULL) {
-        Nan::Set(historyEntry, Nan::New("newName").ToLocalChecked(), Nan::New(to).ToLocalChecked());
+        Nan::Set(historyEntry, strings.Key("newName"), strings.Intern(to));
       }
     }
     return historyEntry;
@@ -60,7 +65,8 @@ public:
     git_commit *currentCommit,
     git_tree *currentTree,
     git_tree *parentTree,
-    const char *filePath
+    const char *filePath,
+    const git_diff_options *diffOptions
   ) {
     int errorCode;
     git_tree_entry *currentEntry;
@@ -80,7 +86,7 @@ public:
     // The filePath was added
     if (currentEntry && !parentEntry) {
       git_diff *diff;
-      if ((errorCode = git_diff_tree_to_tree(&diff, repo, parentTree, currentTree, NULL)) != GIT_OK) {
+      if ((errorCode = git_diff_tree_to_tree(&diff, repo, parentTree, currentTree, diffOptions)) != GIT_OK) {
         git_tree_entry_free(currentEntry);
         return errorCode;
       }
@@ -120,7 +126,7 @@ public:
     // The filePath was deleted
     if (!currentEntry && parentEntry) {
       git_diff *diff;
-      if ((errorCode = git_diff_tree_to_tree(&diff, repo, parentTree, currentTree, NULL)) != GIT_OK) {
+      if ((errorCode = git_diff_tree_to_tree(&diff, repo, parentTree, currentTree, diffOptions)) != GIT_OK) {
         git_tree_entry_free(parentEntry);
         return errorCode;
       }
@@ -172,12 +178,343 @@ public:
     return GIT_OK;
   }
 
+  // Builds the event of currentCommit against one of its parents,
+  // using the cached event if the same commit, parent and path were seen before
+  // in the same cache scope. The cache is not used if cacheScope is NULL.
+  // currentTree is loaded if it is needed and not loaded yet.
+  static int buildHistoryEventForParent(
+    FileHistoryEvent **fileHistoryEvent,
+    git_repository *repo,
+    git_commit *currentCommit,
+    git_tree **currentTree,
+    unsigned int parentIndex,
+    const char *filePath,
+    const git_diff_options *diffOptions,
+    const std::string *cacheScope
+  );
+
   git_delta_t type;
   bool existsInCurrentTree, isMergeCommit;
   const char *from, *to;
   git_commit *commit;
 };
 
+// A bounded LRU of history events by commit, parent and path, shared by all
+// file history walks, so that paging through the history of a file again
+// doesn't have to load and diff the same trees.
+class FileHistoryEventCache {
+  struct Entry {
+    std::string key;
+    git_delta_t type;
+    bool existsInCurrentTree;
+    bool hasFrom, hasTo;
+    std::string from, to;
+  };
+
+  static const size_t capacity = 10000;
+
+  // most recently used first
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> entriesByKey;
+  uv_mutex_t mutex;
+
+public:
+  static FileHistoryEventCache instance;
+
+  FileHistoryEventCache() {
+    uv_mutex_init(&mutex);
+  }
+
+  // The repository and the rename settings git_diff_find_similar reads from
+  // its config, as they change the events of the same commits. Each string is
+  // ended by a NUL, and settings that are not set are marked apart from empty
+  // ones.
+  static std::string Scope(git_repository *repo) {
+    std::string scope(git_repository_path(repo));
+    scope.push_back('\0');
+
+    git_config *config;
+    if (git_repository_config_snapshot(&config, repo) != GIT_OK) {
+      git_error_clear();
+      return scope;
+    }
+    const char *settings[] = { "diff.renames", "diff.renamelimit" };
+    for (size_t i = 0; i < sizeof(settings) / sizeof(settings[0]); ++i) {
+      const char *value;
+      if (git_config_get_string(&value, config, settings[i]) == GIT_OK) {
+        scope.push_back('=');
+        scope.append(value);
+      } else {
+        git_error_clear();
+      }
+      scope.push_back('\0');
+    }
+    git_config_free(config);
+    return scope;
+  }
+
+  // The scope and the diff options that change the event are part of the
+  // key: the flags and the pathspec, each string ended by a NUL
+  static std::string Key(
+    const std::string &scope,
+    const git_oid *commitId,
+    const git_oid *parentId,
+    const git_diff_options *diffOptions,
+    const char *filePath
+  ) {
+    std::string key(scope);
+    key.append((const char *)commitId->id, GIT_OID_RAWSZ);
+    key.append((const char *)parentId->id, GIT_OID_RAWSZ);
+    uint32_t flags = diffOptions != NULL ? diffOptions->flags : GIT_DIFF_NORMAL;
+    key.append((const char *)&flags, sizeof(flags));
+    size_t pathspecCount = diffOptions != NULL ? diffOptions->pathspec.count : 0;
+    key.append((const char *)&pathspecCount, sizeof(pathspecCount));
+    for (size_t i = 0; i < pathspecCount; ++i) {
+      key.append(diffOptions->pathspec.strings[i]);
+      key.push_back('\0');
+    }
+    key.append(filePath);
+    return key;
+  }
+
+  // returns false if there is no event for key
+  bool Get(const std::string &key, git_commit *commit, FileHistoryEvent **fileHistoryEvent) {
+    uv_mutex_lock(&mutex);
+    auto it = entriesByKey.find(key);
+    if (it == entriesByKey.end()) {
+      uv_mutex_unlock(&mutex);
+      return false;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    const Entry &entry = *it->second;
+    *fileHistoryEvent = new FileHistoryEvent(
+      entry.type,
+      entry.existsInCurrentTree,
+      false,
+      commit,
+      entry.hasFrom ? entry.from.c_str() : NULL,
+      entry.hasTo ? entry.to.c_str() : NULL
+    );
+    uv_mutex_unlock(&mutex);
+    return true;
+  }
+
+  void Put(const std::string &key, const FileHistoryEvent *fileHistoryEvent) {
+    uv_mutex_lock(&mutex);
+    if (entriesByKey.find(key) == entriesByKey.end()) {
+      Entry entry;
+      entry.key = key;
+      entry.type = fileHistoryEvent->type;
+      entry.existsInCurrentTree = fileHistoryEvent->existsInCurrentTree;
+      entry.hasFrom = fileHistoryEvent->from != NULL;
+      entry.hasTo = fileHistoryEvent->to != NULL;
+      if (entry.hasFrom) {
+        entry.from = fileHistoryEvent->from;
+      }
+      if (entry.hasTo) {
+        entry.to = fileHistoryEvent->to;
+      }
+      entries.push_front(entry);
+      entriesByKey[key] = entries.begin();
+
+      if (entries.size() > capacity) {
+        entriesByKey.erase(entries.back().key);
+        entries.pop_back();
+      }
+    }
+    uv_mutex_unlock(&mutex);
+  }
+};
+
+const size_t FileHistoryEventCache::capacity;
+FileHistoryEventCache FileHistoryEventCache::instance;
+
+int FileHistoryEvent::buildHistoryEventForParent(
+  FileHistoryEvent **fileHistoryEvent,
+  git_repository *repo,
+  git_commit *currentCommit,
+  git_tree **currentTree,
+  unsigned int parentIndex,
+  const char *filePath,
+  const git_diff_options *diffOptions,
+  const std::string *cacheScope
+) {
+  int errorCode;
+  std::string key;
+  if (cacheScope != NULL) {
+    key = FileHistoryEventCache::Key(
+      *cacheScope,
+      git_commit_id(currentCommit),
+      git_commit_parent_id(currentCommit, parentIndex),
+      diffOptions,
+      filePath
+    );
+    if (FileHistoryEventCache::instance.Get(key, currentCommit, fileHistoryEvent)) {
+      return GIT_OK;
+    }
+  }
+
+  if (*currentTree == NULL && (errorCode = git_commit_tree(currentTree, currentCommit)) != GIT_OK) {
+    return errorCode;
+  }
+
+  git_commit *parentCommit;
+  if ((errorCode = git_commit_parent(&parentCommit, currentCommit, parentIndex)) != GIT_OK) {
+    return errorCode;
+  }
+
+  git_tree *parentTree;
+  if ((errorCode = git_commit_tree(&parentTree, parentCommit)) != GIT_OK) {
+    git_commit_free(parentCommit);
+    return errorCode;
+  }
+
+  errorCode = buildHistoryEvent(
+    fileHistoryEvent,
+    repo,
+    currentCommit,
+    *currentTree,
+    parentTree,
+    filePath,
+    diffOptions
+  );
+
+  git_tree_free(parentTree);
+  git_commit_free(parentCommit);
+
+  if (errorCode == GIT_OK && cacheScope != NULL) {
+    FileHistoryEventCache::instance.Put(key, *fileHistoryEvent);
+  }
+  return errorCode;
+}
+
+// The commits a file history walk has yet to visit and the commits it has
+// hidden, so that another walk can resume where it stopped.
+class FileHistoryCursor {
+  static std::string Key(const git_oid *oid) {
+    return std::string((const char *)oid->id, GIT_OID_RAWSZ);
+  }
+
+  static void KeysToJavascript(
+    v8::Local<v8::Object> object,
+    const char *name,
+    const std::vector<std::string> &keys
+  ) {
+    v8::Local<v8::Array> array = Nan::New<v8::Array>(keys.size());
+    for (unsigned int i = 0; i < keys.size(); ++i) {
+      git_oid oid;
+      git_oid_fromraw(&oid, (const unsigned char *)keys[i].data());
+      Nan::Set(array, Nan::New(i), Nan::New(git_oid_tostr_s(&oid)).ToLocalChecked());
+    }
+    Nan::Set(object, Nan::New(name).ToLocalChecked(), array);
+  }
+
+  static bool KeysFromJavascript(
+    v8::Local<v8::Object> object,
+    const char *name,
+    std::vector<std::string> &keys
+  ) {
+    v8::Local<v8::Value> value = Nan::Get(object, Nan::New(name).ToLocalChecked()).ToLocalChecked();
+    if (!value->IsArray()) {
+      return false;
+    }
+
+    v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(value);
+    for (unsigned int i = 0; i < array->Length(); ++i) {
+      Nan::Utf8String sha(Nan::To<v8::String>(Nan::Get(array, i).ToLocalChecked()).ToLocalChecked());
+      git_oid oid;
+      if (git_oid_fromstr(&oid, *sha) != GIT_OK) {
+        return false;
+      }
+      keys.push_back(Key(&oid));
+    }
+    return true;
+  }
+
+public:
+  // Commits pushed on the walk and parents of the commits visited so far,
+  // that have not been visited yet
+  std::unordered_set<std::string> pending;
+  std::vector<std::string> hidden;
+  // commits visited by this walk, not kept in the cursor
+  std::unordered_set<std::string> visited;
+  bool isResumed;
+
+  FileHistoryCursor() : isResumed(false) {}
+
+  // Reads a cursor returned by an earlier walk, returns false if it is invalid
+  bool FromJavascript(v8::Local<v8::Object> object) {
+    std::vector<std::string> pendingKeys;
+    if (!KeysFromJavascript(object, "pending", pendingKeys) || !KeysFromJavascript(object, "hidden", hidden)) {
+      return false;
+    }
+    pending.insert(pendingKeys.begin(), pendingKeys.end());
+    isResumed = true;
+    return true;
+  }
+
+  v8::Local<v8::Object> ToJavascript() {
+    v8::Local<v8::Object> object = Nan::New<v8::Object>();
+    KeysToJavascript(object, "pending", std::vector<std::string>(pending.begin(), pending.end()));
+    KeysToJavascript(object, "hidden", hidden);
+    return object;
+  }
+
+  // Takes over the commits pushed on and hidden from the walk, so that they
+  // are kept when the walk is resumed
+  int Start(git_revwalk *walk) {
+    return git_revwalk_foreach_input(walk, StartCallback, this);
+  }
+
+  static int StartCallback(const git_oid *oid, int hidden, void *payload) {
+    FileHistoryCursor *cursor = static_cast<FileHistoryCursor *>(payload);
+    if (hidden) {
+      cursor->Hide(oid);
+    } else {
+      cursor->AddPending(oid);
+    }
+    return 0;
+  }
+
+  // Sets up the walk to continue where the walk that returned this cursor stopped
+  int Restore(git_revwalk *walk) {
+    int errorCode;
+    git_oid oid;
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+      git_oid_fromraw(&oid, (const unsigned char *)it->data());
+      if ((errorCode = git_revwalk_push(walk, &oid)) != GIT_OK) {
+        return errorCode;
+      }
+    }
+    for (auto it = hidden.begin(); it != hidden.end(); ++it) {
+      git_oid_fromraw(&oid, (const unsigned char *)it->data());
+      if ((errorCode = git_revwalk_hide(walk, &oid)) != GIT_OK) {
+        return errorCode;
+      }
+    }
+    return GIT_OK;
+  }
+
+  void Visit(const git_oid *oid) {
+    std::string key = Key(oid);
+    pending.erase(key);
+    visited.insert(key);
+  }
+
+  void AddPending(const git_oid *oid) {
+    std::string key = Key(oid);
+    if (visited.find(key) == visited.end()) {
+      pending.insert(key);
+    }
+  }
+
+  void Hide(const git_oid *oid) {
+    pending.erase(Key(oid));
+    hidden.push_back(Key(oid));
+  }
+};
+
 NAN_METHOD(GitRevwalk::FileHistoryWalk)
 {
   if (info.Length() == 0 || !info[0]->IsString()) {
@@ -188,10 +525,46 @@ NAN_METHOD(GitRevwalk::FileHistoryWalk)
     return Nan::ThrowError("Max count is required and must be a number.");
   }
 
-  if (info.Length() == 2 || !info[2]->IsFunction()) {
+  if (info.Length() == 2 || (info.Length() == 3 && !info[2]->IsFunction())) {
     return Nan::ThrowError("Callback is required and must be a Function.");
   }
 
+  if (info.Length() >= 4) {
+    if (!info[2]->IsNull() && !info[2]->IsUndefined() && !info[2]->IsObject()) {
+      return Nan::ThrowError("Options must be an object, null, or undefined.");
+    }
+
+    if (!info[3]->IsFunction()) {
+      return Nan::ThrowError("Callback is required and must be a Function.");
+    }
+  }
+
+  FileHistoryCursor *cursor = new FileHistoryCursor;
+  bool limitToDirectory = false;
+  bool useCache = true;
+  if (info.Length() >= 4 && info[2]->IsObject()) {
+    v8::Local<v8::Object> options = Nan::To<v8::Object>(info[2]).ToLocalChecked();
+
+    v8::Local<v8::String> propName = Nan::New("limitToDirectory").ToLocalChecked();
+    if (Nan::Has(options, propName).FromJust()) {
+      limitToDirectory = Nan::Get(options, propName).ToLocalChecked()->IsTrue();
+    }
+
+    propName = Nan::New("useCache").ToLocalChecked();
+    if (Nan::Has(options, propName).FromJust()) {
+      useCache = !Nan::Get(options, propName).ToLocalChecked()->IsFalse();
+    }
+
+    propName = Nan::New("cursor").ToLocalChecked();
+    v8::Local<v8::Value> cursorValue = Nan::Get(options, propName).ToLocalChecked();
+    if (!cursorValue->IsNull() && !cursorValue->IsUndefined()) {
+      if (!cursorValue->IsObject() || !cursor->FromJavascript(Nan::To<v8::Object>(cursorValue).ToLocalChecked())) {
+        delete cursor;
+        return Nan::ThrowError("Cursor must be the cursor returned by a previous fileHistoryWalk.");
+      }
+    }
+  }
+
   FileHistoryWalkBaton* baton = new FileHistoryWalkBaton;
 
   baton->error_code = GIT_OK;
@@ -199,41 +572,88 @@ NAN_METHOD(GitRevwalk::FileHistoryWalk)
   Nan::Utf8String from_js_file_path(Nan::To<v8::String>(info[0]).ToLocalChecked());
   baton->file_path = strdup(*from_js_file_path);
   baton->max_count = Nan::To<unsigned int>(info[1]).FromJust();
+  baton->limit_to_directory = limitToDirectory;
+  baton->use_cache = useCache;
+  baton->cursor = cursor;
   baton->out = new std::vector<void *>;
   baton->out->reserve(baton->max_count);
   baton->walk = Nan::ObjectWrap::Unwrap<GitRevwalk>(info.This())->GetValue();
 
-  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[2]));
+  Nan::Callback *callback = new Nan::Callback(Local<Function>::Cast(info[2]->IsFunction() ? info[2] : info[3]));
   FileHistoryWalkWorker *worker = new FileHistoryWalkWorker(baton, callback);
   worker->SaveToPersistent("fileHistoryWalk", info.This());
 
-  Nan::AsyncQueueWorker(worker);
+  AsyncLibgit2QueueWorker(worker, baton->walk);
   return;
 }
 
 void GitRevwalk::FileHistoryWalkWorker::Execute()
 {
   git_repository *repo = git_revwalk_repository(baton->walk);
+  FileHistoryCursor *cursor = static_cast<FileHistoryCursor *>(baton->cursor);
   git_oid currentOid;
   git_error_clear();
+
+  if (
+    (baton->error_code = cursor->Start(baton->walk)) != GIT_OK
+    || (cursor->isResumed && (baton->error_code = cursor->Restore(baton->walk)) != GIT_OK)
+  ) {
+    delete baton->out;
+    baton->out = NULL;
+    baton->error = git_error_dup(git_error_last());
+    free((void *)baton->file_path);
+    baton->file_path = NULL;
+    return;
+  }
+
+  // When limited to the directory of the file, only that directory is diffed
+  // to find renames, so renames from other directories are reported as adds
+  // and deletes.
+  std::string directory;
+  char *pathspec;
+  git_diff_options diffOptions = GIT_DIFF_OPTIONS_INIT;
+  const git_diff_options *diffOptionsPointer = NULL;
+  if (baton->limit_to_directory) {
+    const char *lastSlash = strrchr(baton->file_path, '/');
+    if (lastSlash != NULL) {
+      directory.assign(baton->file_path, lastSlash - baton->file_path);
+      pathspec = const_cast<char *>(directory.c_str());
+      diffOptions.flags |= GIT_DIFF_DISABLE_PATHSPEC_MATCH;
+      diffOptions.pathspec.strings = &pathspec;
+      diffOptions.pathspec.count = 1;
+    }
+    diffOptionsPointer = &diffOptions;
+  }
+
+  std::string cacheScope;
+  const std::string *cacheScopePointer = NULL;
+  if (baton->use_cache) {
+    cacheScope = FileHistoryEventCache::Scope(repo);
+    cacheScopePointer = &cacheScope;
+  }
+
   for (
     unsigned int revwalkIterations = 0;
     revwalkIterations < baton->max_count && (baton->error_code = git_revwalk_next(&currentOid, baton->walk)) == GIT_OK;
     ++revwalkIterations
   ) {
+    cursor->Visit(&currentOid);
+
     git_commit *currentCommit;
     if ((baton->error_code = git_commit_lookup(&currentCommit, repo, &currentOid)) != GIT_OK) {
       break;
     }
 
-    git_tree *currentTree;
-    if ((baton->error_code = git_commit_tree(&currentTree, currentCommit)) != GIT_OK) {
-      git_commit_free(currentCommit);
-      break;
-    }
+    // only loaded when the event is not cached
+    git_tree *currentTree = NULL;
 
     const unsigned int parentCount = git_commit_parentcount(currentCommit);
     if (parentCount == 0) {
+      if ((baton->error_code = git_commit_tree(&currentTree, currentCommit)) != GIT_OK) {
+        git_commit_free(currentCommit);
+        break;
+      }
+
       git_tree_entry* entry;
       if (git_tree_entry_bypath(&entry, currentTree, baton->file_path) == GIT_OK) {
         baton->out->push_back(new FileHistoryEvent(GIT_DELTA_ADDED, false, false, currentCommit, NULL, NULL));
@@ -245,74 +665,48 @@ void GitRevwalk::FileHistoryWalkWorker::Execute()
     }
 
     if (parentCount == 1) {
-      git_commit *parentCommit;
-      if ((baton->error_code = git_commit_parent(&parentCommit, currentCommit, 0)) != GIT_OK) {
-        git_commit_free(currentCommit);
-        git_tree_free(currentTree);
-        break;
-      }
-
-      git_tree *parentTree;
-      if ((baton->error_code = git_commit_tree(&parentTree, parentCommit)) != GIT_OK) {
-        git_commit_free(currentCommit);
-        git_commit_free(parentCommit);
-        git_tree_free(currentTree);
-        break;
-      }
-
-
       FileHistoryEvent *fileHistoryEvent;
-      if ((baton->error_code = FileHistoryEvent::buildHistoryEvent(
+      if ((baton->error_code = FileHistoryEvent::buildHistoryEventForParent(
         &fileHistoryEvent,
         repo,
         currentCommit,
-        currentTree,
-        parentTree,
-        baton->file_path
+        &currentTree,
+        0,
+        baton->file_path,
+        diffOptionsPointer,
+        cacheScopePointer
       )) != GIT_OK) {
         git_commit_free(currentCommit);
-        git_commit_free(parentCommit);
         git_tree_free(currentTree);
-        git_tree_free(parentTree);
         break;
       }
 
       if (fileHistoryEvent->type != GIT_DELTA_UNMODIFIED) {
         baton->out->push_back(fileHistoryEvent);
+      } else {
+        delete fileHistoryEvent;
       }
 
+      cursor->AddPending(git_commit_parent_id(currentCommit, 0));
       git_commit_free(currentCommit);
-      git_commit_free(parentCommit);
       git_tree_free(currentTree);
-      git_tree_free(parentTree);
       continue;
     }
 
     std::pair<bool, unsigned int> firstMatchingParentIndex(false, 0);
     bool fileExistsInCurrent = false, fileExistsInSomeParent = false;
     for (unsigned int parentIndex = 0; parentIndex < parentCount; ++parentIndex) {
-      git_commit *parentCommit;
-      if ((baton->error_code = git_commit_parent(&parentCommit, currentCommit, parentIndex)) != GIT_OK) {
-        break;
-      }
-
-      git_tree *parentTree;
-      if ((baton->error_code = git_commit_tree(&parentTree, parentCommit)) != GIT_OK) {
-        git_commit_free(parentCommit);
-        break;
-      }
-
       FileHistoryEvent *fileHistoryEvent;
-      if ((baton->error_code = FileHistoryEvent::buildHistoryEvent(
+      if ((baton->error_code = FileHistoryEvent::buildHistoryEventForParent(
         &fileHistoryEvent,
         repo,
         currentCommit,
-        currentTree,
-        parentTree,
-        baton->file_path
+        &currentTree,
+        parentIndex,
+        baton->file_path,
+        diffOptionsPointer,
+        cacheScopePointer
       )) != GIT_OK) {
-        git_tree_free(parentTree);
-        git_commit_free(parentCommit);
         break;
       }
 
@@ -352,8 +746,6 @@ void GitRevwalk::FileHistoryWalkWorker::Execute()
       }
 
       delete fileHistoryEvent;
-      git_commit_free(parentCommit);
-      git_tree_free(parentTree);
 
      if (firstMatchingParentIndex.first) {
         break;
@@ -386,6 +778,9 @@ void GitRevwalk::FileHistoryWalkWorker::Execute()
         NULL
       );
       baton->out->push_back(fileHistoryEvent);
+      for (unsigned int parentIndex = 0; parentIndex < parentCount; ++parentIndex) {
+        cursor->AddPending(git_commit_parent_id(currentCommit, parentIndex));
+      }
       git_tree_free(currentTree);
       git_commit_free(currentCommit);
       continue;
@@ -393,13 +788,15 @@ void GitRevwalk::FileHistoryWalkWorker::Execute()
 
     assert(firstMatchingParentIndex.first);
     for (unsigned int parentIndex = 0; parentIndex < parentCount; ++parentIndex) {
+      const git_oid *parentOid = git_commit_parent_id(currentCommit, parentIndex);
+      assert(parentOid != NULL);
       if (parentIndex == firstMatchingParentIndex.second) {
+        cursor->AddPending(parentOid);
         continue;
       }
 
-      const git_oid *parentOid = git_commit_parent_id(currentCommit, parentIndex);
-      assert(parentOid != NULL);
       git_revwalk_hide(baton->walk, parentOid);
+      cursor->Hide(parentOid);
     }
     git_commit_free(currentCommit);
     git_tree_free(currentTree);
@@ -420,16 +817,23 @@ void GitRevwalk::FileHistoryWalkWorker::Execute()
 
 void GitRevwalk::FileHistoryWalkWorker::HandleOKCallback()
 {
+  FileHistoryCursor *cursor = static_cast<FileHistoryCursor *>(baton->cursor);
   if (baton->out != NULL) {
     const unsigned int size = baton->out->size();
     v8::Local<v8::Array> result = Nan::New<v8::Array>(size);
+    // the paths of a file repeat across its history
+    StringInterner strings;
     for (unsigned int i = 0; i < size; i++) {
       FileHistoryEvent *batonResult = static_cast<FileHistoryEvent *>(baton->out->at(i));
-      Nan::Set(result, Nan::New(i), batonResult->toJavascript());
+      Nan::Set(result, Nan::New(i), batonResult->toJavascript(strings));
       delete batonResult;
     }
 
     Nan::Set(result, Nan::New("reachedEndOfHistory").ToLocalChecked(), Nan::New(baton->error_code == GIT_ITEROVER));
+    if (baton->error_code != GIT_ITEROVER) {
+      Nan::Set(result, Nan::New("cursor").ToLocalChecked(), cursor->ToJavascript());
+    }
+    delete cursor;
 
     v8::Local<v8::Value> argv[2] = {
       Nan::Null(),
@@ -441,6 +845,8 @@ void GitRevwalk::FileHistoryWalkWorker::HandleOKCallback()
     return;
   }
 
+  delete cursor;
+
   if (baton->error) {
     v8::Local<v8::Object> err;
     if (baton->error->message) {
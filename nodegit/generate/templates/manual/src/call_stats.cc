@@ -0,0 +1,84 @@
+#include <nan.h>
+#include <string.h>
+
+#include "../include/call_stats.h"
+
+bool CallStats::enabled = false;
+std::vector<CallStats::Function *> CallStats::functions;
+
+void CallStats::Histogram::Record(uint64_t duration) {
+  int bucket = 0;
+  while (bucket < bucketCount - 1 && (duration >> (bucket + 1)) != 0) {
+    ++bucket;
+  }
+  ++buckets[bucket];
+  ++count;
+  total += duration;
+  if (duration > max) {
+    max = duration;
+  }
+}
+
+void CallStats::Histogram::Reset() {
+  count = 0;
+  total = 0;
+  max = 0;
+  memset(buckets, 0, sizeof(buckets));
+}
+
+uint64_t CallStats::Histogram::Percentile(double fraction) const {
+  uint64_t rank = (uint64_t)(fraction * count);
+  uint64_t seen = 0;
+  for (int bucket = 0; bucket < bucketCount; ++bucket) {
+    seen += buckets[bucket];
+    if (seen > rank) {
+      uint64_t upperBound = (uint64_t)2 << bucket;
+      return upperBound < max ? upperBound : max;
+    }
+  }
+  return max;
+}
+
+v8::Local<v8::Object> CallStats::Histogram::ToJavascript() const {
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  Nan::Set(result, Nan::New("count").ToLocalChecked(), Nan::New<v8::Number>((double)count));
+  Nan::Set(result, Nan::New("totalMs").ToLocalChecked(), Nan::New<v8::Number>(total / 1e6));
+  Nan::Set(result, Nan::New("averageMs").ToLocalChecked(), Nan::New<v8::Number>(count ? total / 1e6 / count : 0));
+  Nan::Set(result, Nan::New("maxMs").ToLocalChecked(), Nan::New<v8::Number>(max / 1e6));
+  Nan::Set(result, Nan::New("p50Ms").ToLocalChecked(), Nan::New<v8::Number>(Percentile(0.5) / 1e6));
+  Nan::Set(result, Nan::New("p90Ms").ToLocalChecked(), Nan::New<v8::Number>(Percentile(0.9) / 1e6));
+  Nan::Set(result, Nan::New("p99Ms").ToLocalChecked(), Nan::New<v8::Number>(Percentile(0.99) / 1e6));
+  return result;
+}
+
+CallStats::Function *CallStats::Register(const char *name) {
+  Function *function = new Function(name);
+  functions.push_back(function);
+  return function;
+}
+
+void CallStats::Reset() {
+  for (size_t i = 0; i < functions.size(); ++i) {
+    functions[i]->queueWait.Reset();
+    functions[i]->lockWait.Reset();
+    functions[i]->execution.Reset();
+    functions[i]->completionDelay.Reset();
+  }
+}
+
+v8::Local<v8::Object> CallStats::ToJavascript() {
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  for (size_t i = 0; i < functions.size(); ++i) {
+    const Function *function = functions[i];
+    if (function->queueWait.IsEmpty()) {
+      continue;
+    }
+    v8::Local<v8::Object> functionResult = Nan::New<v8::Object>();
+    Nan::Set(functionResult, Nan::New("queueWait").ToLocalChecked(), function->queueWait.ToJavascript());
+    Nan::Set(functionResult, Nan::New("lockWait").ToLocalChecked(), function->lockWait.ToJavascript());
+    Nan::Set(functionResult, Nan::New("execution").ToLocalChecked(), function->execution.ToJavascript());
+    Nan::Set(functionResult, Nan::New("completionDelay").ToLocalChecked(), function->completionDelay.ToJavascript());
+    Nan::Set(result, Nan::New(function->name).ToLocalChecked(), functionResult);
+  }
+  return result;
+}
@@ -13,13 +13,26 @@ using namespace std;
 using namespace v8;
 using namespace node;
 
-void HunkDataFree(HunkData *hunk) {
-  while (!hunk->lines->empty()) {
-    git_diff_line *line = hunk->lines->back();
-    hunk->lines->pop_back();
-    free((void *)line->content);
-    free((void *)line);
+HunkData *HunkDataDup(const HunkData *hunk) {
+  HunkData *copy = new HunkData;
+  copy->hunk = hunk->hunk;
+  copy->numLines = hunk->numLines;
+  copy->contentSize = hunk->contentSize;
+  copy->content = (char *)malloc(hunk->contentSize);
+  memcpy(copy->content, hunk->content, hunk->contentSize);
+
+  // same lines, pointing into the copied content
+  copy->lines = new std::vector<git_diff_line>(*hunk->lines);
+  for (size_t i = 0; i < copy->lines->size(); ++i) {
+    git_diff_line &line = copy->lines->at(i);
+    line.content = copy->content + (line.content - hunk->content);
   }
+
+  return copy;
+}
+
+void HunkDataFree(HunkData *hunk) {
+  free(hunk->content);
   delete hunk->lines;
   delete hunk;
 }
@@ -108,15 +121,10 @@ NAN_METHOD(ConvenientHunk::Lines) {
 void ConvenientHunk::LinesWorker::Execute() {
   baton->lines = new std::vector<git_diff_line *>;
   baton->lines->reserve(baton->hunk->numLines);
-  for (unsigned int i = 0; i < baton->hunk->numLines; ++i) {
+  for (unsigned int i = 0; i < baton->hunk->lines->size(); ++i) {
     git_diff_line *storeLine = (git_diff_line *)malloc(sizeof(git_diff_line));
-    storeLine->origin = baton->hunk->lines->at(i)->origin;
-    storeLine->old_lineno = baton->hunk->lines->at(i)->old_lineno;
-    storeLine->new_lineno = baton->hunk->lines->at(i)->new_lineno;
-    storeLine->num_lines = baton->hunk->lines->at(i)->num_lines;
-    storeLine->content_len = baton->hunk->lines->at(i)->content_len;
-    storeLine->content_offset = baton->hunk->lines->at(i)->content_offset;
-    storeLine->content = strdup(baton->hunk->lines->at(i)->content);
+    *storeLine = baton->hunk->lines->at(i);
+    storeLine->content = strdup(baton->hunk->lines->at(i).content);
     baton->lines->push_back(storeLine);
   }
 }
@@ -130,6 +138,7 @@ void ConvenientHunk::LinesWorker::HandleOKCallback() {
   }
 
   delete baton->lines;
+  delete baton;
 
   Local<v8::Value> argv[2] = {
     Nan::Null(),
@@ -17,21 +17,103 @@ using namespace node;
 void PatchDataFree(PatchData *patch) {
   free((void *)patch->old_file.path);
   free((void *)patch->new_file.path);
-  while(!patch->hunks->empty()) {
-    HunkData *hunk = patch->hunks->back();
-    patch->hunks->pop_back();
-    while (!hunk->lines->empty()) {
-      git_diff_line *line = hunk->lines->back();
-      hunk->lines->pop_back();
-      free((void *)line->content);
-      free((void *)line);
+  if (patch->hunks != NULL) {
+    while (!patch->hunks->empty()) {
+      HunkDataFree(patch->hunks->back());
+      patch->hunks->pop_back();
     }
-    delete hunk;
+    delete patch->hunks;
   }
+  if (patch->raw != NULL) {
+    git_patch_free(patch->raw);
+  }
+  uv_mutex_destroy(&patch->hunksMutex);
   delete patch;
 }
 
-PatchData *createFromRaw(git_patch *raw) {
+static const char noNewlineString[] = "\n\\ No newline at end of file\n";
+static const size_t noNewlineStringLength = sizeof(noNewlineString) - 1;
+
+static HunkData *createHunkFromRaw(git_patch *raw, size_t hunkIndex) {
+  const git_diff_hunk *hunk = NULL;
+  size_t numLines;
+  if (git_patch_get_hunk(&hunk, &numLines, raw, hunkIndex) != 0) {
+    return NULL;
+  }
+
+  HunkData *hunkData = new HunkData;
+  hunkData->numLines = numLines;
+  hunkData->hunk.old_start = hunk->old_start;
+  hunkData->hunk.old_lines = hunk->old_lines;
+  hunkData->hunk.new_start = hunk->new_start;
+  hunkData->hunk.new_lines = hunk->new_lines;
+  hunkData->hunk.header_len = hunk->header_len;
+  memcpy(&hunkData->hunk.header, &hunk->header, 128);
+
+  // When the first line ends with the "No newline" marker, it is appended
+  // to the content of every line of the hunk
+  bool EOFFlag = false;
+  const git_diff_line *line = NULL;
+  if (numLines > 0 && git_patch_get_line_in_hunk(&line, raw, hunkIndex, 0) == 0) {
+    EOFFlag = line->content_len > noNewlineStringLength && !strncmp(
+      &line->content[line->content_len - noNewlineStringLength],
+      noNewlineString,
+      noNewlineStringLength
+    );
+  }
+
+  // size the content buffer first, so line contents can point into it
+  size_t contentSize = 0;
+  for (size_t j = 0; j < numLines; ++j) {
+    if (git_patch_get_line_in_hunk(&line, raw, hunkIndex, j) != 0) {
+      continue;
+    }
+    contentSize += line->content_len + (EOFFlag ? noNewlineStringLength : 0) + 1;
+  }
+
+  hunkData->content = (char *)malloc(contentSize > 0 ? contentSize : 1);
+  hunkData->contentSize = contentSize;
+  hunkData->lines = new std::vector<git_diff_line>;
+  hunkData->lines->reserve(numLines);
+
+  char *content = hunkData->content;
+  for (size_t j = 0; j < numLines; ++j) {
+    if (git_patch_get_line_in_hunk(&line, raw, hunkIndex, j) != 0) {
+      continue;
+    }
+
+    git_diff_line storeLine = *line;
+    storeLine.content = content;
+
+    memcpy(content, line->content, line->content_len);
+    content += line->content_len;
+    if (EOFFlag) {
+      memcpy(content, noNewlineString, noNewlineStringLength);
+      content += noNewlineStringLength;
+    }
+    *content++ = '\0';
+
+    hunkData->lines->push_back(storeLine);
+  }
+
+  return hunkData;
+}
+
+static std::vector<HunkData *> *createHunksFromRaw(git_patch *raw, size_t numHunks) {
+  std::vector<HunkData *> *hunks = new std::vector<HunkData *>;
+  hunks->reserve(numHunks);
+
+  for (size_t i = 0; i < numHunks; ++i) {
+    HunkData *hunkData = createHunkFromRaw(raw, i);
+    if (hunkData != NULL) {
+      hunks->push_back(hunkData);
+    }
+  }
+
+  return hunks;
+}
+
+static PatchData *createPatchData(git_patch *raw) {
   PatchData *patch = new PatchData;
   const git_diff_delta *delta = git_patch_get_delta(raw);
 
@@ -51,76 +133,37 @@ PatchData *createFromRaw(git_patch *raw) {
   );
 
   patch->numHunks = git_patch_num_hunks(raw);
-  patch->hunks = new std::vector<HunkData *>;
-  patch->hunks->reserve(patch->numHunks);
-
-  for (unsigned int i = 0; i < patch->numHunks; ++i) {
-    HunkData *hunkData = new HunkData;
-    const git_diff_hunk *hunk = NULL;
-    int result = git_patch_get_hunk(&hunk, &hunkData->numLines, raw, i);
-    if (result != 0) {
-      continue;
-    }
+  patch->hunks = NULL;
+  patch->raw = NULL;
+  uv_mutex_init(&patch->hunksMutex);
 
-    hunkData->hunk.old_start = hunk->old_start;
-    hunkData->hunk.old_lines = hunk->old_lines;
-    hunkData->hunk.new_start = hunk->new_start;
-    hunkData->hunk.new_lines = hunk->new_lines;
-    hunkData->hunk.header_len = hunk->header_len;
-    memcpy(&hunkData->hunk.header, &hunk->header, 128);
-
-    hunkData->lines = new std::vector<git_diff_line *>;
-    hunkData->lines->reserve(hunkData->numLines);
-
-    static const int noNewlineStringLength = 29;
-    bool EOFFlag = false;
-    for (unsigned int j = 0; j < hunkData->numLines; ++j) {
-      git_diff_line *storeLine = (git_diff_line *)malloc(sizeof(git_diff_line));
-      const git_diff_line *line = NULL;
-      int result = git_patch_get_line_in_hunk(&line, raw, i, j);
-      if (result != 0) {
-        continue;
-      }
-
-      if (j == 0) {
-        int calculatedContentLength = line->content_len;
-        if (
-          calculatedContentLength > noNewlineStringLength &&
-          !strncmp(
-              &line->content[calculatedContentLength - noNewlineStringLength],
-              "\n\\ No newline at end of file\n", (std::min)(calculatedContentLength, noNewlineStringLength)
-        )) {
-          EOFFlag = true;
-        }
-      }
-
-      storeLine->origin = line->origin;
-      storeLine->old_lineno = line->old_lineno;
-      storeLine->new_lineno = line->new_lineno;
-      storeLine->num_lines = line->num_lines;
-      storeLine->content_len = line->content_len;
-      storeLine->content_offset = line->content_offset;
-      char * transferContent;
-      if (EOFFlag) {
-        transferContent = (char *)malloc(storeLine->content_len + noNewlineStringLength + 1);
-        memcpy(transferContent, line->content, storeLine->content_len);
-        memcpy(transferContent + storeLine->content_len, "\n\\ No newline at end of file\n", noNewlineStringLength);
-        transferContent[storeLine->content_len + noNewlineStringLength] = '\0';
-      } else {
-        transferContent = (char *)malloc(storeLine->content_len + 1);
-        memcpy(transferContent, line->content, storeLine->content_len);
-        transferContent[storeLine->content_len] = '\0';
-      }
-      storeLine->content = strdup(transferContent);
-      free((void *)transferContent);
-      hunkData->lines->push_back(storeLine);
-    }
-    patch->hunks->push_back(hunkData);
-  }
+  return patch;
+}
+
+PatchData *createFromRaw(git_patch *raw) {
+  PatchData *patch = createPatchData(raw);
+  patch->hunks = createHunksFromRaw(raw, patch->numHunks);
+  return patch;
+}
 
+PatchData *createLazyFromRaw(git_patch *raw) {
+  PatchData *patch = createPatchData(raw);
+  patch->raw = raw;
   return patch;
 }
 
+std::vector<HunkData *> *PatchDataGetHunks(PatchData *patch) {
+  uv_mutex_lock(&patch->hunksMutex);
+  if (patch->hunks == NULL) {
+    patch->hunks = createHunksFromRaw(patch->raw, patch->numHunks);
+    // the hunks hold copies of everything needed from the patch now
+    git_patch_free(patch->raw);
+    patch->raw = NULL;
+  }
+  uv_mutex_unlock(&patch->hunksMutex);
+  return patch->hunks;
+}
+
 ConvenientPatch::ConvenientPatch(PatchData *raw) {
   this->patch = raw;
 }
@@ -222,35 +265,14 @@ NAN_METHOD(ConvenientPatch::Hunks) {
 }
 
 void ConvenientPatch::HunksWorker::Execute() {
+  std::vector<HunkData *> *hunks = PatchDataGetHunks(baton->patch);
+
   // copy hunks
   baton->hunks = new std::vector<HunkData *>;
-  baton->hunks->reserve(baton->patch->numHunks);
-
-  for (unsigned int i = 0; i < baton->patch->numHunks; ++i) {
-    HunkData *hunkData = new HunkData;
-    hunkData->numLines = baton->patch->hunks->at(i)->numLines;
-    hunkData->hunk.old_start = baton->patch->hunks->at(i)->hunk.old_start;
-    hunkData->hunk.old_lines = baton->patch->hunks->at(i)->hunk.old_lines;
-    hunkData->hunk.new_start = baton->patch->hunks->at(i)->hunk.new_start;
-    hunkData->hunk.new_lines = baton->patch->hunks->at(i)->hunk.new_lines;
-    hunkData->hunk.header_len = baton->patch->hunks->at(i)->hunk.header_len;
-    memcpy(&hunkData->hunk.header, &baton->patch->hunks->at(i)->hunk.header, 128);
-
-    hunkData->lines = new std::vector<git_diff_line *>;
-    hunkData->lines->reserve(hunkData->numLines);
-
-    for (unsigned int j = 0; j < hunkData->numLines; ++j) {
-      git_diff_line *storeLine = (git_diff_line *)malloc(sizeof(git_diff_line));
-      storeLine->origin = baton->patch->hunks->at(i)->lines->at(j)->origin;
-      storeLine->old_lineno = baton->patch->hunks->at(i)->lines->at(j)->old_lineno;
-      storeLine->new_lineno = baton->patch->hunks->at(i)->lines->at(j)->new_lineno;
-      storeLine->num_lines = baton->patch->hunks->at(i)->lines->at(j)->num_lines;
-      storeLine->content_len = baton->patch->hunks->at(i)->lines->at(j)->content_len;
-      storeLine->content_offset = baton->patch->hunks->at(i)->lines->at(j)->content_offset;
-      storeLine->content = strdup(baton->patch->hunks->at(i)->lines->at(j)->content);
-      hunkData->lines->push_back(storeLine);
-    }
-    baton->hunks->push_back(hunkData);
+  baton->hunks->reserve(hunks->size());
+
+  for (unsigned int i = 0; i < hunks->size(); ++i) {
+    baton->hunks->push_back(HunkDataDup(hunks->at(i)));
   }
 }
 
@@ -263,6 +285,7 @@ void ConvenientPatch::HunksWorker::HandleOKCallback() {
   }
 
   delete baton->hunks;
+  delete baton;
 
   Local<v8::Value> argv[2] = {
     Nan::Null(),
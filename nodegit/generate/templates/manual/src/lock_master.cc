@@ -1,37 +1,67 @@
 #include <nan.h>
 #include <git2.h>
 #include <uv.h>
+#include <atomic>
 #include <set>
 #include <vector>
-#include <map>
-#include <algorithm>
+#include <unordered_map>
 
 #include "../include/lock_master.h"
 
 // information about a lockable object
-// - the mutex used to lock it and the number of outstanding locks
+// - the mutex used to lock it and the number of outstanding locks.
+// The mutex is a read/write lock so that LockMasters in Shared mode
+// can hold it at the same time.
 struct ObjectInfo {
-  uv_mutex_t *mutex;
+  uv_rwlock_t *mutex;
   unsigned useCount;
 
-  ObjectInfo(uv_mutex_t *mutex, unsigned useCount)
+  ObjectInfo(uv_rwlock_t *mutex, unsigned useCount)
     : mutex(mutex), useCount(useCount)
   {}
 };
 
+// A part of the map from objects that are locked (or were locked) to their mutexes.
+// Objects are spread over the shards by the hash of their address, so that
+// unrelated objects rarely wait on each other to find their mutex.
+struct MutexShard {
+  std::unordered_map<const void *, ObjectInfo> mutexes;
+  // A mutex used for the mutexes map of this shard
+  uv_mutex_t mapMutex;
+  // the number of stored mutexes not used by any LockMaster,
+  // so that cleanup can skip shards with nothing to clean
+  std::atomic<int> unusedCount;
+};
+
 // LockMaster implementation details
 // implemented in a separate class to keep LockMaster opaque
 class LockMasterImpl {
   // STATIC variables / methods
 
-  // A map from objects that are locked (or were locked), to information on their mutex
-  static std::map<const void *, ObjectInfo> mutexes;
-  // A mutex used for the mutexes map
-  static uv_mutex_t mapMutex;
+  static const unsigned shardCount = 64;
+  // at most this many shards with unused mutexes are cleaned per GC cycle
+  static const unsigned shardsPerCleanup = 8;
+
+  static MutexShard shards[shardCount];
+  // the shard the next cleanup starts with
+  static unsigned cleanupCursor;
 
   // A libuv key used to store the current thread-specific LockMasterImpl instance
   static uv_key_t currentLockMasterKey;
 
+  // contention counters reported in the diagnostics
+  static std::atomic<uint64_t> lockedMutexesCount;
+  static std::atomic<uint64_t> sharedMutexesCount;
+  static std::atomic<uint64_t> contendedMutexesCount;
+  static std::atomic<uint64_t> contendedShardsCount;
+
+  static MutexShard &ShardFor(const void *object) {
+    // fibonacci hashing spreads the (aligned) addresses over the shards
+    uint32_t hash = (uint32_t)((uintptr_t)object >> 3) * 2654435761u;
+    return shards[hash >> 26];
+  }
+  static void LockShard(MutexShard &shard);
+
   // Cleans up any mutexes that are not currently used
   static NAN_GC_CALLBACK(CleanupMutexes);
 
@@ -41,21 +71,34 @@ public:
   // INSTANCE variables / methods
 
 private:
+  // The mode the mutexes are locked in. It doesn't change after construction,
+  // so that re-locking after a TemporaryUnlock and unlocking match the first lock.
+  LockMaster::Mode mode;
   // The set of objects this LockMaster is responsible for locking
   std::set<const void *> objectsToLock;
-
-  // Mutexes locked by this LockMaster on construction and unlocked on destruction
-  std::vector<uv_mutex_t *> GetMutexes(int useCountDelta);
+  // The mutexes of objectsToLock, looked up when first locked.
+  // Their use count keeps them alive until they are released.
+  std::vector<uv_rwlock_t *> objectMutexes;
+
+  // Looks up the mutexes of objectsToLock, and counts this LockMaster as using them
+  void AcquireMutexes();
+  // Stops counting this LockMaster as using the mutexes of objectsToLock
+  void ReleaseMutexes();
   void Register();
   void Unregister();
 
+  // return 0 on success, like uv_mutex_trylock
+  int TryLockMutex(uv_rwlock_t *mutex);
+  void LockMutex(uv_rwlock_t *mutex);
+  void UnlockMutex(uv_rwlock_t *mutex);
+
 public:
   static LockMasterImpl *CurrentLockMasterImpl() {
     return (LockMasterImpl *)uv_key_get(&currentLockMasterKey);
   }
   static LockMaster::Diagnostics GetDiagnostics();
 
-  LockMasterImpl() {
+  LockMasterImpl(LockMaster::Mode mode) : mode(mode) {
     Register();
   }
 
@@ -69,19 +112,37 @@ public:
   }
 
   void Lock(bool acquireMutexes);
+  // Locks every mutex without waiting, or returns false having locked none
+  bool TryLock();
   void Unlock(bool releaseMutexes);
 };
 
-std::map<const void *, ObjectInfo> LockMasterImpl::mutexes;
-uv_mutex_t LockMasterImpl::mapMutex;
+const unsigned LockMasterImpl::shardCount;
+const unsigned LockMasterImpl::shardsPerCleanup;
+MutexShard LockMasterImpl::shards[LockMasterImpl::shardCount];
+unsigned LockMasterImpl::cleanupCursor = 0;
 uv_key_t LockMasterImpl::currentLockMasterKey;
+std::atomic<uint64_t> LockMasterImpl::lockedMutexesCount(0);
+std::atomic<uint64_t> LockMasterImpl::sharedMutexesCount(0);
+std::atomic<uint64_t> LockMasterImpl::contendedMutexesCount(0);
+std::atomic<uint64_t> LockMasterImpl::contendedShardsCount(0);
 
 void LockMasterImpl::Initialize() {
-  uv_mutex_init(&mapMutex);
+  for (unsigned i = 0; i < shardCount; i++) {
+    uv_mutex_init(&shards[i].mapMutex);
+    shards[i].unusedCount.store(0);
+  }
   uv_key_create(&currentLockMasterKey);
   Nan::AddGCEpilogueCallback(CleanupMutexes);
 }
 
+void LockMasterImpl::LockShard(MutexShard &shard) {
+  if (uv_mutex_trylock(&shard.mapMutex)) {
+    contendedShardsCount++;
+    uv_mutex_lock(&shard.mapMutex);
+  }
+}
+
 NAN_GC_CALLBACK(LockMasterImpl::CleanupMutexes) {
   // skip cleanup if thread safety is disabled
   // this means that turning thread safety on and then off
@@ -91,59 +152,91 @@ NAN_GC_CALLBACK(LockMasterImpl::CleanupMutexes) {
     return;
   }
 
-  uv_mutex_lock(&mapMutex);
-
-  for (auto it = mutexes.begin(); it != mutexes.end(); )
-  {
-    uv_mutex_t *mutex = it->second.mutex;
-    unsigned useCount = it->second.useCount;
-    // if the mutex is not used by any LockMasters,
-    // we can destroy it
-    if (!useCount) {
-      uv_mutex_destroy(mutex);
-      free(mutex);
-      auto to_erase = it;
-      it++;
-      mutexes.erase(to_erase);
-    } else {
-      it++;
+  // clean a few shards per GC cycle, picking up where the last cycle stopped,
+  // so that a cycle never has to walk every stored mutex
+  unsigned cleanedShards = 0;
+  for (unsigned i = 0; i < shardCount && cleanedShards < shardsPerCleanup; i++) {
+    MutexShard &shard = shards[cleanupCursor];
+    cleanupCursor = (cleanupCursor + 1) % shardCount;
+
+    if (!shard.unusedCount.load()) {
+      continue;
+    }
+    cleanedShards++;
+
+    uv_mutex_lock(&shard.mapMutex);
+
+    for (auto it = shard.mutexes.begin(); it != shard.mutexes.end(); )
+    {
+      uv_rwlock_t *mutex = it->second.mutex;
+      unsigned useCount = it->second.useCount;
+      // if the mutex is not used by any LockMasters,
+      // we can destroy it
+      if (!useCount) {
+        uv_rwlock_destroy(mutex);
+        free(mutex);
+        it = shard.mutexes.erase(it);
+        shard.unusedCount--;
+      } else {
+        it++;
+      }
     }
-  }
 
-  uv_mutex_unlock(&mapMutex);
+    uv_mutex_unlock(&shard.mapMutex);
+  }
 }
 
 void LockMaster::Initialize() {
   LockMasterImpl::Initialize();
 }
 
-std::vector<uv_mutex_t *> LockMasterImpl::GetMutexes(int useCountDelta) {
-  std::vector<uv_mutex_t *> objectMutexes;
-
-  uv_mutex_lock(&mapMutex);
+void LockMasterImpl::AcquireMutexes() {
+  objectMutexes.clear();
+  objectMutexes.reserve(objectsToLock.size());
 
   for (auto object : objectsToLock) {
     if(object) {
+      MutexShard &shard = ShardFor(object);
+      LockShard(shard);
+
       // ensure we have an initialized mutex for each object
-      auto mutexIt = mutexes.find(object);
-      if(mutexIt == mutexes.end()) {
-        mutexIt = mutexes.insert(
+      auto mutexIt = shard.mutexes.find(object);
+      if(mutexIt == shard.mutexes.end()) {
+        mutexIt = shard.mutexes.insert(
           std::make_pair(
             object,
-            ObjectInfo((uv_mutex_t *)malloc(sizeof(uv_mutex_t)), 0U)
+            ObjectInfo((uv_rwlock_t *)malloc(sizeof(uv_rwlock_t)), 0U)
           )
         ).first;
-        uv_mutex_init(mutexIt->second.mutex);
+        uv_rwlock_init(mutexIt->second.mutex);
+      } else if (!mutexIt->second.useCount) {
+        shard.unusedCount--;
       }
 
       objectMutexes.push_back(mutexIt->second.mutex);
-      mutexIt->second.useCount += useCountDelta;
+      mutexIt->second.useCount++;
+
+      uv_mutex_unlock(&shard.mapMutex);
     }
   }
+}
 
-  uv_mutex_unlock(&mapMutex);
+void LockMasterImpl::ReleaseMutexes() {
+  for (auto object : objectsToLock) {
+    if(object) {
+      MutexShard &shard = ShardFor(object);
+      LockShard(shard);
+
+      auto mutexIt = shard.mutexes.find(object);
+      if (!--mutexIt->second.useCount) {
+        shard.unusedCount++;
+      }
 
-  return objectMutexes;
+      uv_mutex_unlock(&shard.mapMutex);
+    }
+  }
+
+  objectMutexes.clear();
 }
 
 void LockMasterImpl::Register() {
@@ -154,15 +247,37 @@ void LockMasterImpl::Unregister() {
   uv_key_set(&currentLockMasterKey, NULL);
 }
 
+int LockMasterImpl::TryLockMutex(uv_rwlock_t *mutex) {
+  return mode == LockMaster::Shared ? uv_rwlock_tryrdlock(mutex) : uv_rwlock_trywrlock(mutex);
+}
+
+void LockMasterImpl::LockMutex(uv_rwlock_t *mutex) {
+  if (mode == LockMaster::Shared) {
+    uv_rwlock_rdlock(mutex);
+  } else {
+    uv_rwlock_wrlock(mutex);
+  }
+}
+
+void LockMasterImpl::UnlockMutex(uv_rwlock_t *mutex) {
+  if (mode == LockMaster::Shared) {
+    uv_rwlock_rdunlock(mutex);
+  } else {
+    uv_rwlock_wrunlock(mutex);
+  }
+}
+
 void LockMasterImpl::Lock(bool acquireMutexes) {
-  std::vector<uv_mutex_t *> objectMutexes = GetMutexes(acquireMutexes * 1);
+  if (acquireMutexes) {
+    AcquireMutexes();
+  }
 
   auto alreadyLocked = objectMutexes.end();
 
   // we will attempt to lock all the mutexes at the same time to avoid deadlocks
   // note in most cases we are locking 0 or 1 mutexes. more than 1 implies
   // passing objects with different repos/owners in the same call.
-  std::vector<uv_mutex_t *>::iterator it;
+  std::vector<uv_rwlock_t *>::iterator it;
   do {
     // go through all the mutexes and try to lock them
     for(it = objectMutexes.begin(); it != objectMutexes.end(); it++) {
@@ -172,15 +287,18 @@ void LockMasterImpl::Lock(bool acquireMutexes) {
         continue;
       }
       // first, try to lock (non-blocking)
-      bool failure = uv_mutex_trylock(*it);
+      bool failure = TryLockMutex(*it);
       if(failure) {
+        contendedMutexesCount++;
         // we have failed to lock a mutex... unlock everything we have locked
-        std::for_each(objectMutexes.begin(), it, uv_mutex_unlock);
+        for (auto locked = objectMutexes.begin(); locked != it; locked++) {
+          UnlockMutex(*locked);
+        }
         if (alreadyLocked > it && alreadyLocked != objectMutexes.end()) {
-          uv_mutex_unlock(*alreadyLocked);
+          UnlockMutex(*alreadyLocked);
         }
         // now do a blocking lock on what we couldn't lock
-        uv_mutex_lock(*it);
+        LockMutex(*it);
         // mark that we have already locked this one
         // if there are more mutexes than this one, we will go back to locking everything
         alreadyLocked = it;
@@ -188,30 +306,68 @@ void LockMasterImpl::Lock(bool acquireMutexes) {
       }
     }
   } while(it != objectMutexes.end());
+
+  lockedMutexesCount += objectMutexes.size();
+  if (mode == LockMaster::Shared) {
+    sharedMutexesCount += objectMutexes.size();
+  }
 }
 
-void LockMasterImpl::Unlock(bool releaseMutexes) {
-  // Get the mutexes but don't decrement their use count until after we've
-  // unlocked them all.
-  std::vector<uv_mutex_t *> objectMutexes = GetMutexes(0);
+bool LockMasterImpl::TryLock() {
+  AcquireMutexes();
 
-  std::for_each(objectMutexes.begin(), objectMutexes.end(), uv_mutex_unlock);
+  for (auto it = objectMutexes.begin(); it != objectMutexes.end(); it++) {
+    if (TryLockMutex(*it)) {
+      contendedMutexesCount++;
+      for (auto locked = objectMutexes.begin(); locked != it; locked++) {
+        UnlockMutex(*locked);
+      }
+      ReleaseMutexes();
+      // nothing is left to unlock or release on destruction
+      objectsToLock.clear();
+      return false;
+    }
+  }
 
-  GetMutexes(releaseMutexes * -1);
+  lockedMutexesCount += objectMutexes.size();
+  if (mode == LockMaster::Shared) {
+    sharedMutexesCount += objectMutexes.size();
+  }
+  return true;
+}
+
+void LockMasterImpl::Unlock(bool releaseMutexes) {
+  // Unlock the mutexes but don't stop using them until after we've
+  // unlocked them all, so that they can't be cleaned up while still locked.
+  for (auto it = objectMutexes.begin(); it != objectMutexes.end(); it++) {
+    UnlockMutex(*it);
+  }
+
+  if (releaseMutexes) {
+    ReleaseMutexes();
+  }
 }
 
 LockMaster::Diagnostics LockMasterImpl::GetDiagnostics() {
   LockMaster::Diagnostics diagnostics;
-  uv_mutex_lock(&LockMasterImpl::mapMutex);
-  diagnostics.storedMutexesCount = mutexes.size();
-  uv_mutex_unlock(&LockMasterImpl::mapMutex);
+  diagnostics.storedMutexesCount = 0;
+  for (unsigned i = 0; i < shardCount; i++) {
+    uv_mutex_lock(&shards[i].mapMutex);
+    diagnostics.storedMutexesCount += shards[i].mutexes.size();
+    uv_mutex_unlock(&shards[i].mapMutex);
+  }
+  diagnostics.lockedMutexesCount = lockedMutexesCount;
+  diagnostics.sharedMutexesCount = sharedMutexesCount;
+  diagnostics.contendedMutexesCount = contendedMutexesCount;
+  diagnostics.contendedShardsCount = contendedShardsCount;
   return diagnostics;
 }
 
 // LockMaster
 
-void LockMaster::ConstructorImpl() {
-  impl = new LockMasterImpl();
+void LockMaster::ConstructorImpl(Mode mode) {
+  // without read/write locking, readers take the same exclusive locks as writers
+  impl = new LockMasterImpl(readWriteLocking ? mode : Exclusive);
 }
 
 void LockMaster::DestructorImpl() {
@@ -222,8 +378,12 @@ void LockMaster::ObjectToLock(const void *objectToLock) {
   impl->ObjectToLock(objectToLock);
 }
 
-void LockMaster::ObjectsToLockAdded() {
-  impl->Lock(true);
+void LockMaster::ObjectsToLockAdded(bool tryLock) {
+  if (tryLock) {
+    locked = impl->TryLock();
+  } else {
+    impl->Lock(true);
+  }
 }
 
 LockMaster::Diagnostics LockMaster::GetDiagnostics() {
@@ -244,3 +404,4 @@ void LockMaster::TemporaryUnlock::DestructorImpl() {
 }
 
 LockMaster::Status LockMaster::status = LockMaster::Disabled;
+bool LockMaster::readWriteLocking = false;
@@ -87,6 +87,11 @@ v8::Local<v8::Value> NodeGitWrapper<Traits>::New(const typename Traits::cType *r
     ).ToLocalChecked());
 }
 
+template<typename Traits>
+bool NodeGitWrapper<Traits>::HasInstance(v8::Local<v8::Value> value) {
+  return !function_template.IsEmpty() && Nan::New(function_template)->HasInstance(value);
+}
+
 template<typename Traits>
 typename Traits::cType *NodeGitWrapper<Traits>::GetValue() {
   return raw;
@@ -100,6 +105,9 @@ void NodeGitWrapper<Traits>::ClearValue() {
 template<typename Traits>
 Nan::Persistent<v8::Function> NodeGitWrapper<Traits>::constructor_template;
 
+template<typename Traits>
+Nan::Persistent<v8::FunctionTemplate> NodeGitWrapper<Traits>::function_template;
+
 template<typename Traits>
 int NodeGitWrapper<Traits>::SelfFreeingInstanceCount;
 
@@ -118,6 +126,7 @@ NAN_METHOD(NodeGitWrapper<Traits>::GetNonSelfFreeingConstructedCount) {
 
 template<typename Traits>
 void NodeGitWrapper<Traits>::InitializeTemplate(v8::Local<v8::FunctionTemplate> &tpl) {
+  function_template.Reset(tpl);
   Nan::SetMethod(tpl, "getSelfFreeingInstanceCount", GetSelfFreeingInstanceCount);
   Nan::SetMethod(tpl, "getNonSelfFreeingConstructedCount", GetNonSelfFreeingConstructedCount);
 }
@@ -1,24 +1,29 @@
 #include "../include/reference_counter.h"
 
 void ReferenceCounter::incrementCountForPointer(void *ptr) {
-  LockMaster(true, &referenceCountByPointer);
-  if (referenceCountByPointer.find(ptr) == referenceCountByPointer.end()) {
-    referenceCountByPointer[ptr] = 1;
-  } else {
-    referenceCountByPointer[ptr] = referenceCountByPointer[ptr] + 1;
-  }
+  Shard &shard = ShardFor(ptr);
+  uv_mutex_lock(&shard.mutex);
+  // a missing pointer is value-initialized to 0
+  shard.referenceCountByPointer[ptr]++;
+  uv_mutex_unlock(&shard.mutex);
 }
 
 unsigned long ReferenceCounter::decrementCountForPointer(void *ptr) {
-  LockMaster(true, &referenceCountByPointer);
-  unsigned long referenceCount = referenceCountByPointer[ptr];
-  if (referenceCount == 1) {
-    referenceCountByPointer.erase(ptr);
-    return 0;
-  } else {
-    referenceCountByPointer[ptr] = referenceCount - 1;
-    return referenceCountByPointer[ptr];
+  Shard &shard = ShardFor(ptr);
+  uv_mutex_lock(&shard.mutex);
+  // a pointer that isn't counted (any more) is never reported as unreferenced,
+  // so that it can't be freed twice
+  unsigned long referenceCount = 1;
+  auto it = shard.referenceCountByPointer.find(ptr);
+  if (it != shard.referenceCountByPointer.end()) {
+    referenceCount = --it->second;
+    if (!referenceCount) {
+      shard.referenceCountByPointer.erase(it);
+    }
   }
+  uv_mutex_unlock(&shard.mutex);
+  return referenceCount;
 }
 
-std::unordered_map<void *, unsigned long> ReferenceCounter::referenceCountByPointer;
+const unsigned ReferenceCounter::shardCount;
+ReferenceCounter::Shard ReferenceCounter::shards[ReferenceCounter::shardCount];
@@ -0,0 +1,76 @@
+#include <nan.h>
+#include <string.h>
+
+#include "../include/string_interner.h"
+
+static bool isAscii(const char *str, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    if ((unsigned char)str[i] >= 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+v8::Local<v8::String> StringInterner::New(const char *str) {
+  return New(str, strlen(str));
+}
+
+v8::Local<v8::String> StringInterner::New(const char *str, size_t length) {
+  // ASCII is valid Latin-1, which V8 can copy without decoding
+  if (isAscii(str, length)) {
+    return Nan::NewOneByteString((const uint8_t *)str, (int)length).ToLocalChecked();
+  }
+  return Nan::New<v8::String>(str, (int)length).ToLocalChecked();
+}
+
+v8::Local<v8::Value> StringInterner::NewOrNull(const char *str) {
+  if (str == NULL) {
+    return Nan::Null();
+  }
+  return New(str);
+}
+
+v8::Local<v8::String> StringInterner::Intern(const char *str) {
+  return Intern(str, strlen(str));
+}
+
+v8::Local<v8::String> StringInterner::Intern(const char *str, size_t length) {
+  if (length > maxInternedLength) {
+    return New(str, length);
+  }
+
+  std::string key(str, length);
+  std::unordered_map<std::string, v8::Local<v8::String>>::iterator interned = strings.find(key);
+  if (interned != strings.end()) {
+    ++hits;
+    return interned->second;
+  }
+
+  ++misses;
+  v8::Local<v8::String> string = New(str, length);
+  strings.insert(std::make_pair(key, string));
+  return string;
+}
+
+v8::Local<v8::Value> StringInterner::InternOrNull(const char *str) {
+  if (str == NULL) {
+    return Nan::Null();
+  }
+  return Intern(str);
+}
+
+v8::Local<v8::String> StringInterner::Key(const char *name) {
+  std::unordered_map<const char *, v8::Local<v8::String>>::iterator key = keys.find(name);
+  if (key != keys.end()) {
+    return key->second;
+  }
+
+  v8::Local<v8::String> string = v8::String::NewFromOneByte(
+    v8::Isolate::GetCurrent(),
+    (const uint8_t *)name,
+    v8::NewStringType::kInternalized
+  ).ToLocalChecked();
+  keys.insert(std::make_pair(name, string));
+  return string;
+}
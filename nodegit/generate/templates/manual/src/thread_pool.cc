@@ -1,8 +1,114 @@
 #include "../include/thread_pool.h"
 
-ThreadPool::ThreadPool(int numberOfThreads, uv_loop_t *loop) {
-  uv_mutex_init(&workMutex);
-  uv_sem_init(&workSemaphore, 0);
+#include <algorithm>
+
+// ThreadPool::WorkQueue
+
+ThreadPool::WorkQueue::WorkQueue(size_t capacity)
+  : cells(new Cell[capacity]), mask(capacity - 1) {
+  for (size_t i = 0; i < capacity; i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  enqueuePosition.store(0, std::memory_order_relaxed);
+  dequeuePosition.store(0, std::memory_order_relaxed);
+}
+
+ThreadPool::WorkQueue::~WorkQueue() {
+  delete[] cells;
+}
+
+bool ThreadPool::WorkQueue::Push(const Work &work) {
+  Cell *cell;
+  size_t position = enqueuePosition.load(std::memory_order_relaxed);
+  for ( ; ; ) {
+    cell = &cells[position & mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+    if (difference == 0) {
+      // the cell is free - claim it
+      if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // the cell still holds work from the previous lap
+      return false;
+    } else {
+      // another producer claimed the cell first
+      position = enqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->work = work;
+  // publish the work to consumers
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+bool ThreadPool::WorkQueue::Pop(Work &work) {
+  Cell *cell;
+  size_t position = dequeuePosition.load(std::memory_order_relaxed);
+  for ( ; ; ) {
+    cell = &cells[position & mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+    if (difference == 0) {
+      // the cell holds published work - claim it
+      if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // nothing has been published in this cell yet
+      return false;
+    } else {
+      // another consumer claimed the cell first
+      position = dequeuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  work = cell->work;
+  // hand the cell back to producers for the next lap
+  cell->sequence.store(position + mask + 1, std::memory_order_release);
+  return true;
+}
+
+bool ThreadPool::WorkQueue::IsEmpty() const {
+  return dequeuePosition.load(std::memory_order_relaxed) >= enqueuePosition.load(std::memory_order_relaxed);
+}
+
+size_t ThreadPool::WorkQueue::Size() const {
+  size_t dequeued = dequeuePosition.load(std::memory_order_relaxed);
+  size_t enqueued = enqueuePosition.load(std::memory_order_relaxed);
+  return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+// ThreadPool::Worker
+
+ThreadPool::Worker::Worker(ThreadPool *threadPool, int index)
+  : threadPool(threadPool), index(index), wakePending(false), workPriority(Interactive) {
+  uv_mutex_init(&wakeMutex);
+  uv_cond_init(&wakeCondition);
+  isIdle.store(false);
+  busySince.store(0);
+}
+
+// ThreadPool
+
+thread_local ThreadPool::Worker *ThreadPool::currentWorker = NULL;
+
+ThreadPool::ThreadPool(int numberOfThreads, uv_loop_t *loop)
+  : numberOfThreads(numberOfThreads), workersStarted(false), nextWorker(0),
+    currentPriority(-1), loopCallbacksBudget(defaultLoopCallbacksBudget) {
+  reservedWorkers.store(numberOfThreads > 1 ? 1 : 0);
+  affinityScheduling.store(false);
+
+  uv_mutex_init(&overflowMutex);
+  for (int i = 0; i < PriorityCount; i++) {
+    overflowCounts[i].store(0);
+    priorityCounters[i].queuedCount.store(0);
+    priorityCounters[i].startedCount.store(0);
+    priorityCounters[i].totalWaitTime.store(0);
+    priorityCounters[i].maxWaitTime.store(0);
+  }
 
   uv_async_init(loop, &loopAsync, RunLoopCallbacks);
   loopAsync.data = this;
@@ -10,22 +116,300 @@ ThreadPool::ThreadPool(int numberOfThreads, uv_loop_t *loop) {
   uv_mutex_init(&loopMutex);
 
   workInProgressCount = 0;
+}
+
+bool ThreadPool::SetNumberOfThreads(int numberOfThreads) {
+  if (workersStarted || numberOfThreads < 1) {
+    return false;
+  }
+  this->numberOfThreads = numberOfThreads;
+  if (reservedWorkers >= numberOfThreads) {
+    reservedWorkers = numberOfThreads - 1;
+  }
+  return true;
+}
+
+bool ThreadPool::SetReservedWorkers(int reservedWorkers) {
+  if (reservedWorkers < 0 || reservedWorkers >= numberOfThreads) {
+    return false;
+  }
+  this->reservedWorkers = reservedWorkers;
+  return true;
+}
+
+bool ThreadPool::GetCurrentPriority(Priority &priority) const {
+  if (currentPriority < 0) {
+    return false;
+  }
+  priority = (Priority)currentPriority;
+  return true;
+}
 
-  for(int i=0; i<numberOfThreads; i++) {
-    uv_thread_t thread;
-    uv_thread_create(&thread, RunEventQueue, this);
+void ThreadPool::SetOwnerPriority(const void *owner, int priority) {
+  if (priority < 0) {
+    ownerPriorities.erase(owner);
+  } else {
+    ownerPriorities[owner] = (Priority)priority;
   }
 }
 
-void ThreadPool::QueueWork(Callback workCallback, Callback completionCallback, void *data) {
-  uv_mutex_lock(&workMutex);
+bool ThreadPool::GetOwnerPriority(const void *owner, Priority &priority) const {
+  if (!owner || ownerPriorities.empty()) {
+    return false;
+  }
+  auto it = ownerPriorities.find(owner);
+  if (it == ownerPriorities.end()) {
+    return false;
+  }
+  priority = it->second;
+  return true;
+}
+
+ThreadPool::PriorityStats ThreadPool::GetPriorityStats(Priority priority) const {
+  const PriorityCounters &counters = priorityCounters[priority];
+  PriorityStats stats;
+  stats.queuedCount = counters.queuedCount;
+  stats.startedCount = counters.startedCount;
+  stats.totalWaitTime = counters.totalWaitTime;
+  stats.maxWaitTime = counters.maxWaitTime;
+  return stats;
+}
+
+void ThreadPool::StartWorkers() {
+  workersStarted = true;
+
+  // all queues must exist before any worker starts stealing
+  for (int i = 0; i < numberOfThreads; i++) {
+    workers.push_back(new Worker(this, i));
+  }
+
+  for (int i = 0; i < numberOfThreads; i++) {
+    uv_thread_create(&workers[i]->thread, RunEventQueue, workers[i]);
+  }
+}
+
+bool ThreadPool::Serves(Worker *worker, Priority priority) const {
+  return worker->index >= FirstServingWorker(priority);
+}
+
+int ThreadPool::FirstServingWorker(Priority priority) const {
+  return priority == Interactive ? 0 : reservedWorkers.load(std::memory_order_relaxed);
+}
+
+ThreadPool::Worker *ThreadPool::HomeWorker(const void *owner, Priority priority) const {
+  int firstWorker = FirstServingWorker(priority);
+  // fibonacci hashing spreads the (aligned) addresses over the workers
+  uint32_t hash = (uint32_t)((uintptr_t)owner >> 3) * 2654435761u;
+  return workers[firstWorker + (hash >> 16) % (numberOfThreads - firstWorker)];
+}
+
+bool ThreadPool::IsSaturated(Worker *worker) const {
+  size_t queued = 0;
+  for (int priority = Interactive; priority < PriorityCount; priority++) {
+    queued += worker->homeQueues[priority].Size();
+  }
+  if (queued >= affinityQueueLimit) {
+    return true;
+  }
+  uint64_t busySince = worker->busySince.load(std::memory_order_relaxed);
+  return busySince && uv_hrtime() - busySince > affinityBusyLimit;
+}
+
+uint64_t ThreadPool::TimeUntilStealable(Worker *worker) const {
+  if (!affinityScheduling.load(std::memory_order_relaxed)) {
+    return 0;
+  }
+
+  uint64_t now = uv_hrtime();
+  uint64_t wait = 0;
+  for (int i = 1; i < numberOfThreads; i++) {
+    Worker *victim = workers[(worker->index + i) % numberOfThreads];
+    bool hasWork = false;
+    for (int priority = Interactive; priority < PriorityCount && Serves(worker, (Priority)priority); priority++) {
+      hasWork = hasWork || !victim->homeQueues[priority].IsEmpty();
+    }
+    if (!hasWork) {
+      continue;
+    }
+
+    // a victim between two pieces of work gets a full period to take it
+    uint64_t busySince = victim->busySince.load(std::memory_order_relaxed);
+    uint64_t busyTime = busySince && now > busySince ? now - busySince : 0;
+    uint64_t victimWait = busyTime < affinityBusyLimit ? affinityBusyLimit - busyTime : 0;
+    victimWait = std::max(victimWait, affinityMinimumWait);
+    if (!wait || victimWait < wait) {
+      wait = victimWait;
+    }
+  }
+  return wait;
+}
+
+void ThreadPool::QueueWork(Callback workCallback, Callback completionCallback, void *data,
+    Priority priority, const void *owner) {
+  if (!workersStarted) {
+    StartWorkers();
+  }
+
   // there is work on the thread pool - reference the handle so
   // node doesn't terminate
   uv_ref((uv_handle_t *)&loopAsync);
-  workQueue.push(Work(workCallback, completionCallback, data));
   workInProgressCount++;
-  uv_mutex_unlock(&workMutex);
-  uv_sem_post(&workSemaphore);
+
+  Work work(workCallback, completionCallback, data, priority, owner);
+  priorityCounters[priority].queuedCount++;
+
+  Worker *targetWorker = NULL;
+  bool affinity = owner && affinityScheduling.load(std::memory_order_relaxed);
+  if (affinity) {
+    Worker *homeWorker = HomeWorker(owner, priority);
+    if (homeWorker->homeQueues[priority].Push(work)) {
+      // wake the home worker if it is idle. Otherwise wake another worker,
+      // which steals the work if the home worker is saturated, or else
+      // looks again once the home worker has been busy for too long.
+      WakeIdleWorker(homeWorker, priority);
+      return;
+    }
+    // the home worker is far behind, let any worker take it
+  }
+
+  // only workers serving the priority ever take the work from their queue.
+  // Prefer one that is waiting for work, so the work starts right away.
+  int firstWorker = FirstServingWorker(priority);
+  int servingWorkers = numberOfThreads - firstWorker;
+  for (int i = firstWorker; !targetWorker && i < numberOfThreads; i++) {
+    if (workers[i]->isIdle.load(std::memory_order_relaxed)) {
+      targetWorker = workers[i];
+    }
+  }
+  if (!targetWorker) {
+    targetWorker = workers[firstWorker + nextWorker++ % servingWorkers];
+  }
+
+  int targetIndex = targetWorker->index - firstWorker;
+  bool queued = targetWorker->workQueues[priority].Push(work);
+  for (int i = 1; !queued && i < servingWorkers; i++) {
+    queued = workers[firstWorker + (targetIndex + i) % servingWorkers]->workQueues[priority].Push(work);
+  }
+  if (!queued) {
+    // every worker queue is full
+    uv_mutex_lock(&overflowMutex);
+    overflowQueues[priority].push(work);
+    overflowCounts[priority]++;
+    uv_mutex_unlock(&overflowMutex);
+  }
+
+  WakeIdleWorker(targetWorker, priority);
+}
+
+bool ThreadPool::ClaimIdleWorker(Worker *worker) {
+  bool expected = true;
+  if (worker->isIdle.load(std::memory_order_relaxed) &&
+      worker->isIdle.compare_exchange_strong(expected, false)) {
+    uv_mutex_lock(&worker->wakeMutex);
+    worker->wakePending = true;
+    uv_cond_signal(&worker->wakeCondition);
+    uv_mutex_unlock(&worker->wakeMutex);
+    return true;
+  }
+  return false;
+}
+
+bool ThreadPool::WaitForClaim(Worker *worker, uint64_t timeout) {
+  uv_mutex_lock(&worker->wakeMutex);
+  uint64_t deadline = timeout ? uv_hrtime() + timeout : 0;
+  while (!worker->wakePending) {
+    if (!deadline) {
+      uv_cond_wait(&worker->wakeCondition, &worker->wakeMutex);
+      continue;
+    }
+    uint64_t now = uv_hrtime();
+    if (now >= deadline ||
+        uv_cond_timedwait(&worker->wakeCondition, &worker->wakeMutex, deadline - now) == UV_ETIMEDOUT) {
+      break;
+    }
+  }
+  bool claimed = worker->wakePending;
+  worker->wakePending = false;
+  uv_mutex_unlock(&worker->wakeMutex);
+  return claimed;
+}
+
+void ThreadPool::WakeIdleWorker(Worker *preferredWorker, Priority priority) {
+  // pairs with the fence in RunEventQueue: either the worker sees the work
+  // we just queued, or we see that it is idle
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  for (int i = 0; i < numberOfThreads; i++) {
+    Worker *worker = preferredWorker
+      ? workers[(preferredWorker->index + i) % numberOfThreads]
+      : workers[i];
+    if (Serves(worker, priority) && ClaimIdleWorker(worker)) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::TakeWork(Worker *worker, Work &work) {
+  for (int priority = Interactive; priority < PriorityCount; priority++) {
+    if (!Serves(worker, (Priority)priority)) {
+      break;
+    }
+    if (TakeWork(worker, (Priority)priority, work)) {
+      RecordStart(work);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::TakeWork(Worker *worker, Priority priority, Work &work) {
+  if (worker->homeQueues[priority].Pop(work) || worker->workQueues[priority].Pop(work)) {
+    return true;
+  }
+
+  // steal from the other workers, starting with our neighbour. Work queued
+  // for its owner's home worker only from home workers that can't keep up,
+  // unless affinity scheduling has been turned off since.
+  bool affinity = affinityScheduling.load(std::memory_order_relaxed);
+  for (int i = 1; i < numberOfThreads; i++) {
+    Worker *victim = workers[(worker->index + i) % numberOfThreads];
+    if (victim->workQueues[priority].Pop(work)) {
+      return true;
+    }
+    if (!victim->homeQueues[priority].IsEmpty() && (!affinity || IsSaturated(victim)) &&
+        victim->homeQueues[priority].Pop(work)) {
+      return true;
+    }
+  }
+
+  if (overflowCounts[priority].load() > 0) {
+    bool found = false;
+    uv_mutex_lock(&overflowMutex);
+    if (!overflowQueues[priority].empty()) {
+      work = overflowQueues[priority].front();
+      overflowQueues[priority].pop();
+      overflowCounts[priority]--;
+      found = true;
+    }
+    uv_mutex_unlock(&overflowMutex);
+    return found;
+  }
+
+  return false;
+}
+
+void ThreadPool::RecordStart(const Work &work) {
+  PriorityCounters &counters = priorityCounters[work.priority];
+  uint64_t waitTime = uv_hrtime() - work.queuedAt;
+
+  counters.queuedCount--;
+  counters.startedCount++;
+  counters.totalWaitTime += waitTime;
+
+  uint64_t maxWaitTime = counters.maxWaitTime.load(std::memory_order_relaxed);
+  while (waitTime > maxWaitTime &&
+         !counters.maxWaitTime.compare_exchange_weak(maxWaitTime, waitTime)) {
+  }
 }
 
 void ThreadPool::QueueLoopCallback(Callback callback, void *data, bool isWork) {
@@ -35,7 +419,8 @@ void ThreadPool::QueueLoopCallback(Callback callback, void *data, bool isWork) {
   bool queueWasEmpty = loopQueue.empty();
   loopQueue.push(loopCallback);
   // we only trigger RunLoopCallbacks via the loopAsync handle if the queue
-  // was empty.  Otherwise, we depend on RunLoopCallbacks to re-trigger itself
+  // was empty.  Otherwise, a pending RunLoopCallbacks will take this callback
+  // along with the rest of the queue
   if (queueWasEmpty) {
     uv_async_send(&loopAsync);
   }
@@ -46,25 +431,141 @@ void ThreadPool::ExecuteReverseCallback(Callback reverseCallback, void *data) {
   QueueLoopCallback(reverseCallback, data, false);
 }
 
-void ThreadPool::RunEventQueue(void *threadPool) {
-  static_cast<ThreadPool *>(threadPool)->RunEventQueue();
+void ThreadPool::RunParallel(ParallelCallback callback, void *data, size_t count, int maxThreads) {
+  ParallelWork *parallelWork = new ParallelWork;
+  parallelWork->callback = callback;
+  parallelWork->data = data;
+  parallelWork->count = count;
+  parallelWork->nextIndex.store(0);
+  parallelWork->doneCount = 0;
+  uv_mutex_init(&parallelWork->mutex);
+  uv_cond_init(&parallelWork->doneCondition);
+  parallelWork->references.store(1);
+
+  // only ask workers that would otherwise sit idle. A helper whose worker
+  // got busy in the meantime runs later, and finds nothing left to call.
+  Worker *self = currentWorker;
+  if (self && self->threadPool == this) {
+    Priority priority = self->workPriority;
+    size_t helpers = 0;
+    for (int i = 1; i < numberOfThreads && (int)helpers + 1 < maxThreads && helpers + 1 < count; i++) {
+      Worker *worker = workers[(self->index + i) % numberOfThreads];
+      if (!worker->isIdle.load(std::memory_order_relaxed) || !Serves(worker, priority)) {
+        continue;
+      }
+
+      Work work(RunParallelHelper, NULL, parallelWork, priority, NULL);
+      parallelWork->references++;
+      priorityCounters[priority].queuedCount++;
+      if (!worker->workQueues[priority].Push(work)) {
+        parallelWork->references--;
+        priorityCounters[priority].queuedCount--;
+        continue;
+      }
+      ClaimIdleWorker(worker);
+      helpers++;
+    }
+  }
+
+  RunParallelCalls(parallelWork);
+
+  // every call has been taken, wait for those still running on helpers
+  uv_mutex_lock(&parallelWork->mutex);
+  while (parallelWork->doneCount < count) {
+    uv_cond_wait(&parallelWork->doneCondition, &parallelWork->mutex);
+  }
+  uv_mutex_unlock(&parallelWork->mutex);
+
+  ReleaseParallelWork(parallelWork);
+}
+
+void ThreadPool::RunParallelCalls(ParallelWork *parallelWork) {
+  size_t doneCount = 0;
+  for (size_t index = parallelWork->nextIndex++; index < parallelWork->count; index = parallelWork->nextIndex++) {
+    (*parallelWork->callback)(parallelWork->data, index);
+    doneCount++;
+  }
+
+  if (doneCount) {
+    uv_mutex_lock(&parallelWork->mutex);
+    parallelWork->doneCount += doneCount;
+    if (parallelWork->doneCount == parallelWork->count) {
+      uv_cond_signal(&parallelWork->doneCondition);
+    }
+    uv_mutex_unlock(&parallelWork->mutex);
+  }
+}
+
+void ThreadPool::RunParallelHelper(void *parallelWork) {
+  RunParallelCalls(static_cast<ParallelWork *>(parallelWork));
+  ReleaseParallelWork(static_cast<ParallelWork *>(parallelWork));
+}
+
+void ThreadPool::ReleaseParallelWork(ParallelWork *parallelWork) {
+  if (--parallelWork->references == 0) {
+    uv_mutex_destroy(&parallelWork->mutex);
+    uv_cond_destroy(&parallelWork->doneCondition);
+    delete parallelWork;
+  }
+}
+
+void ThreadPool::RunEventQueue(void *worker) {
+  Worker *self = static_cast<Worker *>(worker);
+  self->threadPool->RunEventQueue(self);
 }
 
-void ThreadPool::RunEventQueue() {
+void ThreadPool::RunEventQueue(Worker *worker) {
+  currentWorker = worker;
+
   for ( ; ; ) {
-    // wait until there is work to do
-    uv_sem_wait(&workSemaphore);
-    uv_mutex_lock(&workMutex);
-    // the semaphore should guarantee that queue is not empty
-    Work work = workQueue.front();
-    workQueue.pop();
-    uv_mutex_unlock(&workMutex);
+    Work work;
+    if (!TakeWork(worker, work)) {
+      // announce that we are idle, then look once more so that work queued
+      // concurrently with the announcement cannot be missed
+      worker->isIdle.store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      bool found = TakeWork(worker, work);
+      // wait until someone claims us. If work waits for a busy worker we
+      // may not steal from yet, look again once we may.
+      if (!found && WaitForClaim(worker, TimeUntilStealable(worker))) {
+        continue;
+      }
+
+      // we found work or timed out, so we are no longer idle
+      bool expected = true;
+      if (!worker->isIdle.compare_exchange_strong(expected, false)) {
+        // a producer claimed us in the meantime - consume its wakeup
+        WaitForClaim(worker, 0);
+      }
+
+      if (!found) {
+        continue;
+      }
+    }
+
+    worker->busySince.store(uv_hrtime(), std::memory_order_relaxed);
+
+    // if more work is waiting behind this one, let an idle worker steal it.
+    // With affinity scheduling, it only does once we have been busy for too
+    // long, so that short work stays with us.
+    for (int priority = Interactive; priority < PriorityCount; priority++) {
+      if (!worker->workQueues[priority].IsEmpty() || !worker->homeQueues[priority].IsEmpty()) {
+        WakeIdleWorker(NULL, (Priority)priority);
+        break;
+      }
+    }
 
     // perform the queued work
+    worker->workPriority = work.priority;
     (*work.workCallback)(work.data);
+    worker->busySince.store(0, std::memory_order_relaxed);
 
-    // schedule the completion callback on the loop
-    QueueLoopCallback(work.completionCallback, work.data, true);
+    // schedule the completion callback on the loop. RunParallel helpers
+    // have none.
+    if (work.completionCallback) {
+      QueueLoopCallback(work.completionCallback, work.data, true);
+    }
   }
 }
 
@@ -73,30 +574,46 @@ void ThreadPool::RunLoopCallbacks(uv_async_t* handle) {
 }
 
 void ThreadPool::RunLoopCallbacks() {
-  // get the next callback to run
+  // take everything that has completed so far under a single lock.
+  // Producers see an empty loopQueue afterwards, so the next completion
+  // triggers RunLoopCallbacks again.
   uv_mutex_lock(&loopMutex);
-  LoopCallback loopCallback = loopQueue.front();
+  if (loopBatch.empty()) {
+    std::swap(loopBatch, loopQueue);
+  } else {
+    // callbacks left over from the previous tick run first
+    while (!loopQueue.empty()) {
+      loopBatch.push(loopQueue.front());
+      loopQueue.pop();
+    }
+  }
   uv_mutex_unlock(&loopMutex);
 
-  // perform the queued loop callback
-  (*loopCallback.callback)(loopCallback.data);
+  uint64_t deadline = loopCallbacksBudget ? uv_hrtime() + loopCallbacksBudget : 0;
+  while (!loopBatch.empty()) {
+    LoopCallback loopCallback = loopBatch.front();
+    loopBatch.pop();
 
-  // pop the queue, and if necessary, re-trigger RunLoopCallbacks
-  uv_mutex_lock(&loopMutex);
-  loopQueue.pop();
-  if (!loopQueue.empty()) {
+    // perform the queued loop callback
+    (*loopCallback.callback)(loopCallback.data);
+
+    if (loopCallback.isWork) {
+      workInProgressCount--;
+    }
+
+    if (deadline && uv_hrtime() >= deadline) {
+      break;
+    }
+  }
+
+  // out of budget - let the loop breathe and finish the batch on the next tick
+  if (!loopBatch.empty()) {
     uv_async_send(&loopAsync);
   }
-  uv_mutex_unlock(&loopMutex);
 
   // if there is no ongoing work / completion processing, node doesn't need
   // to be prevented from terminating
-  if (loopCallback.isWork) {
-    uv_mutex_lock(&workMutex);
-    workInProgressCount --;
-    if(!workInProgressCount) {
-      uv_unref((uv_handle_t *)&loopAsync);
-    }
-    uv_mutex_unlock(&workMutex);
+  if (!workInProgressCount) {
+    uv_unref((uv_handle_t *)&loopAsync);
   }
 }
@@ -74,15 +74,63 @@ NAN_METHOD({{ cppClassName }}::{{ cppFunctionName }}) {
     {%endif%}
   {%endeach%}
 
-  AsyncLibgit2QueueWorker(worker);
+  if (CallStats::IsEnabled()) {
+    static CallStats::Function *callStats = CallStats::Register("{{ jsClassName }}.{{ jsFunctionName }}");
+    worker->callTimer.Queued(callStats);
+  }
+
+  {%if cacheLookup %}
+  {
+    // Objects already parsed in the repository's cache are returned right
+    // away instead of taking a round trip through the thread pool.
+    // The lock is only tried, so a busy repository never blocks the loop.
+    git_object *cachedObject = NULL;
+    int cachedResult = GIT_ENOTFOUND;
+    {
+      LockMaster lockMaster(LockMaster::TryLock, LockMaster::Shared, baton->repo);
+      if (lockMaster.IsLocked()) {
+        cachedResult = git_object_lookup_cached(&cachedObject, baton->repo, baton->id, {{= cacheLookup =}});
+      }
+    }
+    // The call is only timed as started here if it hit, otherwise Execute
+    // starts it. A miss counts the probe as time spent queued.
+    if (cachedResult == GIT_OK) {
+      worker->callTimer.Started();
+      worker->callTimer.Locked();
+      worker->callTimer.Executed();
+      {%each args|argsInfo as arg %}
+        {%if arg.isReturn %}
+          baton->{{ arg.name }} = ({{= arg.cType|replace "**" "*" =}})cachedObject;
+        {%endif%}
+      {%endeach%}
+      AsyncLibgit2Complete(worker);
+      return;
+    }
+  }
+  {%endif%}
+
+  AsyncLibgit2QueueWorker(
+    worker
+    {%each args|argsInfo as arg %}
+      {%if not arg.isReturn %}
+        {%if arg.cType|isPointer%}
+          {%if not arg.cType|isDoublePointer%}
+            ,baton->{{ arg.name }}
+          {%endif%}
+        {%endif%}
+      {%endif%}
+    {%endeach%}
+  );
   return;
 }
 
 void {{ cppClassName }}::{{ cppFunctionName }}Worker::Execute() {
   git_error_clear();
+  callTimer.Started();
 
   {
     LockMaster lockMaster(
+      {%if isReadOnly %}LockMaster::Shared,{%endif%}
       /*asyncAction: */true
       {%each args|argsInfo as arg %}
         {%if arg.cType|isPointer%}
@@ -92,6 +140,7 @@ void {{ cppClassName }}::{{ cppFunctionName }}Worker::Execute() {
         {%endif%}
       {%endeach%}
     );
+    callTimer.Locked();
 
   {%if .|hasReturnType %}
     {{ return.cType }} result = {{ cFunctionName }}(
@@ -104,6 +153,7 @@ void {{ cppClassName }}::{{ cppFunctionName }}Worker::Execute() {
       {%if arg.isReturn|and arg.cType|isDoublePointer %}&{%endif%}baton->{{ arg.name }}{%if not arg.lastArg %},{%endif%}
     {%endeach%}
   );
+    callTimer.Executed();
 
     {%if return.isResultOrError %}
       baton->error_code = result;
@@ -127,6 +177,8 @@ void {{ cppClassName }}::{{ cppFunctionName }}Worker::Execute() {
 }
 
 void {{ cppClassName }}::{{ cppFunctionName }}Worker::HandleOKCallback() {
+  callTimer.Completed();
+
   {%if return.isResultOrError %}
     if (baton->error_code >= GIT_OK) {
   {%else%}
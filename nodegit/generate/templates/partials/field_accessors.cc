@@ -49,6 +49,7 @@
         Nan::Callback *callback = NULL;
         int throttle = {%if field.return.throttle %}{{ field.return.throttle }}{%else%}0{%endif%};
         bool waitForResult = true;
+        bool coalesce = false;
 
         if (value->IsFunction()) {
           callback = new Nan::Callback(value.As<Function>());
@@ -74,6 +75,13 @@
                 Local<Value> objectWaitForResult = maybeObjectWaitForResult.ToLocalChecked();
                 waitForResult = Nan::To<bool>(objectWaitForResult).FromJust();
               }
+              {% if field.return.coalescable %}
+
+              Nan::MaybeLocal<Value> maybeObjectCoalesce = Nan::Get(object, Nan::New("coalesce").ToLocalChecked());
+              if(!maybeObjectCoalesce.IsEmpty()) {
+                coalesce = maybeObjectCoalesce.ToLocalChecked()->IsTrue();
+              }
+              {% endif %}
             }
           }
         }
@@ -82,7 +90,7 @@
             wrapper->raw->{{ field.name }} = ({{ field.cType }}){{ field.name }}_cppCallback;
           }
 
-          wrapper->{{ field.name }}.SetCallback(callback, throttle, waitForResult);
+          wrapper->{{ field.name }}.SetCallback(callback, throttle, waitForResult, coalesce);
         }
 
       {% elsif field.payloadFor %}
@@ -137,6 +145,22 @@
 
         {{ cppClassName }}* instance = {{ field.name }}_getInstanceFromBaton(baton);
 
+        {% if field.return.coalescable %}
+          if (instance->{{ field.name }}.ShouldCoalesce()) {
+            {% if field.return.type != "void" %}
+              {{ field.return.type }} result = instance->{{ field.name }}.GetCoalescedResult(baton->defaultResult);
+            {% endif %}
+            {% each field.args|argsInfo as arg %}
+              baton->{{ arg.name }} = CoalescedCopy({{ arg.name }});
+            {% endeach %}
+            baton->isCoalesced = true;
+            if (instance->{{ field.name }}.StoreCoalesced(baton)) {
+              libgit2ThreadPool.ExecuteReverseCallback({{ field.name }}_coalescedAsync, instance);
+            }
+            return{% if field.return.type != "void" %} result{% endif %};
+          }
+
+        {% endif %}
         {% if field.return.type == "void" %}
           if (instance->{{ field.name }}.WillBeThrottled()) {
             delete baton;
@@ -188,7 +212,12 @@
             {% if arg.isEnum %}
               Nan::New((int)baton->{{ arg.name }})
             {% elsif arg.isLibgitType %}
-              {{ arg.cppClassName }}::New(baton->{{ arg.name }}, false)
+              {% if field.return.coalescable %}
+                // the wrapper takes over a coalesced copy, which JS may keep
+                {{ arg.cppClassName }}::New(baton->{{ arg.name }}, baton->isCoalesced)
+              {% else %}
+                {{ arg.cppClassName }}::New(baton->{{ arg.name }}, false)
+              {% endif %}
             {% elsif arg.cType == "size_t" %}
               // HACK: NAN should really have an overload for Nan::New to support size_t
               Nan::New((unsigned int)baton->{{ arg.name }})
@@ -202,6 +231,16 @@
             {% endeach %}
           };
         {% endif %}
+        {% if field.return.coalescable %}
+
+          if (baton->isCoalesced) {
+            {% each field.args|callbackArgsInfo as arg %}
+              {% if arg.isLibgitType %}
+                baton->{{ arg.name }} = NULL;
+              {% endif %}
+            {% endeach %}
+          }
+        {% endif %}
 
         Nan::TryCatch tryCatch;
 
@@ -247,6 +286,28 @@
         {% endif %}
       }
 
+      {% if field.return.coalescable %}
+        // Delivers the latest coalesced call, if it has not been delivered yet
+        void {{ cppClassName }}::{{ field.name }}_coalescedAsync(void *untypedInstance) {
+          {{ cppClassName }}* instance = static_cast<{{ cppClassName }}*>(untypedInstance);
+          {{ field.name|titleCase }}Baton* baton = static_cast<{{ field.name|titleCase }}Baton*>(instance->{{ field.name }}.TakeCoalesced());
+          if (baton == NULL) {
+            return;
+          }
+
+          baton->onCompletion = {{ field.name }}_coalescedCompleted;
+          {{ field.name }}_async(baton);
+        }
+
+        void {{ cppClassName }}::{{ field.name }}_coalescedCompleted(AsyncBaton *untypedBaton) {
+          {{ field.name|titleCase }}Baton* baton = static_cast<{{ field.name|titleCase }}Baton*>(untypedBaton);
+          {% if field.return.type != "void" %}
+            {{ field.name }}_getInstanceFromBaton(baton)->{{ field.name }}.SetCoalescedResult(baton->result);
+          {% endif %}
+          delete baton;
+        }
+
+      {% endif %}
       void {{ cppClassName }}::{{ field.name }}_promiseCompleted(bool isFulfilled, AsyncBaton *_baton, v8::Local<v8::Value> result) {
         Nan::HandleScope scope;
 
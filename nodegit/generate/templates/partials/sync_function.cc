@@ -35,6 +35,7 @@ NAN_METHOD({{ cppClassName }}::{{ cppFunctionName }}) {
 
   { // lock master scope start
     LockMaster lockMaster(
+      {%if isReadOnly %}LockMaster::Shared,{%endif%}
       /*asyncAction: */false
       {%each args|argsInfo as arg %}
         {%if arg.cType|isPointer%}
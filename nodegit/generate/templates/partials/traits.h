@@ -26,6 +26,10 @@ struct {{ cppClassName }}Traits {
     referenceCount = ReferenceCounter::decrementCountForPointer((void *)raw);
     {% endif %}
     if (referenceCount == 0) {
+      {% if isSingleton %}
+      // a later object could be allocated at the same address
+      libgit2ThreadPool.SetOwnerPriority(raw, -1);
+      {% endif %}
       ::{{ freeFunctionName }}(raw); // :: to avoid calling this free recursively
     }
   {% else %}
@@ -47,6 +47,7 @@
       },
       "sources": [
         "src/async_baton.cc",
+        "src/call_stats.cc",
         "src/lock_master.cc",
         "src/reference_counter.cc",
         "src/nodegit.cc",
@@ -60,6 +61,7 @@
         "src/filter_registry.cc",
         "src/git_buf_converter.cc",
         "src/str_array_converter.cc",
+        "src/string_interner.cc",
         "src/thread_pool.cc",
         {% each %}
           {% if type != "enum" %}
@@ -8,7 +8,9 @@
 #include <sstream>
 
 #include "async_baton.h"
+#include "call_stats.h"
 #include "nodegit_wrapper.h"
+#include "object_pool.h"
 #include "promise_completion.h"
 #include "reference_counter.h"
 
@@ -124,7 +126,7 @@ class {{ cppClassName }} : public
       {%if not function.ignore %}
         {%if function.isAsync %}
 
-    struct {{ function.cppFunctionName }}Baton {
+    struct {{ function.cppFunctionName }}Baton : public PooledObject<{{ function.cppFunctionName }}Baton> {
       int error_code;
       const git_error* error;
       {%each function.args as arg%}
@@ -138,7 +140,7 @@ class {{ cppClassName }} : public
         {%endif%}
       {%endeach%}
     };
-    class {{ function.cppFunctionName }}Worker : public Nan::AsyncWorker {
+    class {{ function.cppFunctionName }}Worker : public Nan::AsyncWorker, public PooledObject<{{ function.cppFunctionName }}Worker> {
       public:
         {{ function.cppFunctionName }}Worker(
             {{ function.cppFunctionName }}Baton *_baton,
@@ -149,6 +151,8 @@ class {{ cppClassName }} : public
         void Execute();
         void HandleOKCallback();
 
+        CallTimer callTimer;
+
       private:
         {{ function.cppFunctionName }}Baton *baton;
     };
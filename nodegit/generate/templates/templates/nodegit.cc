@@ -11,6 +11,8 @@
 #include "../include/init_ssh2.h"
 #include "../include/lock_master.h"
 #include "../include/nodegit.h"
+#include "../include/object_pool.h"
+#include "../include/call_stats.h"
 #include "../include/wrapper.h"
 #include "../include/promise_completion.h"
 #include "../include/functions/copy.h"
@@ -80,15 +82,199 @@ void LockMasterGetStatus(const FunctionCallbackInfo<Value>& info) {
   info.GetReturnValue().Set(Nan::New(LockMaster::GetStatus()));
 }
 
+void LockMasterSetReadWriteLocking(const FunctionCallbackInfo<Value>& info) {
+  Nan::HandleScope scope;
+
+  if (info.Length() == 0 || !info[0]->IsBoolean()) {
+    return Nan::ThrowError("Read/write locking is required and must be a Boolean.");
+  }
+
+  LockMaster::SetReadWriteLocking(Nan::To<bool>(info[0]).FromJust());
+}
+
+void LockMasterGetReadWriteLocking(const FunctionCallbackInfo<Value>& info) {
+  info.GetReturnValue().Set(Nan::New(LockMaster::GetReadWriteLocking()));
+}
+
 void LockMasterGetDiagnostics(const FunctionCallbackInfo<Value>& info) {
   LockMaster::Diagnostics diagnostics(LockMaster::GetDiagnostics());
 
   // return a plain JS object with properties
   v8::Local<v8::Object> result = Nan::New<v8::Object>();
   Nan::Set(result, Nan::New("storedMutexesCount").ToLocalChecked(), Nan::New(diagnostics.storedMutexesCount));
+  Nan::Set(result, Nan::New("lockedMutexesCount").ToLocalChecked(), Nan::New<v8::Number>((double)diagnostics.lockedMutexesCount));
+  Nan::Set(result, Nan::New("sharedMutexesCount").ToLocalChecked(), Nan::New<v8::Number>((double)diagnostics.sharedMutexesCount));
+  Nan::Set(result, Nan::New("contendedMutexesCount").ToLocalChecked(), Nan::New<v8::Number>((double)diagnostics.contendedMutexesCount));
+  Nan::Set(result, Nan::New("contendedShardsCount").ToLocalChecked(), Nan::New<v8::Number>((double)diagnostics.contendedShardsCount));
+  info.GetReturnValue().Set(result);
+}
+
+void ThreadPoolSetSize(const FunctionCallbackInfo<Value>& info) {
+  Nan::HandleScope scope;
+
+  if (info.Length() == 0 || !info[0]->IsNumber()) {
+    return Nan::ThrowError("Thread pool size is required and must be a Number.");
+  }
+
+  int size = Nan::To<int32_t>(info[0]).FromJust();
+  if (size < 1) {
+    return Nan::ThrowError("Thread pool size must be at least 1.");
+  }
+
+  if (!libgit2ThreadPool.SetNumberOfThreads(size)) {
+    return Nan::ThrowError("Thread pool size cannot be changed after the first asynchronous call.");
+  }
+}
+
+void ThreadPoolGetSize(const FunctionCallbackInfo<Value>& info) {
+  info.GetReturnValue().Set(Nan::New(libgit2ThreadPool.GetNumberOfThreads()));
+}
+
+void ThreadPoolSetCompletionBudget(const FunctionCallbackInfo<Value>& info) {
+  Nan::HandleScope scope;
+
+  if (info.Length() == 0 || !info[0]->IsNumber()) {
+    return Nan::ThrowError("Completion budget is required and must be a Number.");
+  }
+
+  double milliseconds = Nan::To<double>(info[0]).FromJust();
+  if (milliseconds < 0) {
+    return Nan::ThrowError("Completion budget must not be negative.");
+  }
+
+  libgit2ThreadPool.SetLoopCallbacksBudget((uint64_t)(milliseconds * 1e6));
+}
+
+void ThreadPoolGetCompletionBudget(const FunctionCallbackInfo<Value>& info) {
+  info.GetReturnValue().Set(Nan::New<v8::Number>(libgit2ThreadPool.GetLoopCallbacksBudget() / 1e6));
+}
+
+bool ThreadPoolPriorityFromValue(v8::Local<v8::Value> value, int &priority) {
+  if (value->IsNull() || value->IsUndefined()) {
+    priority = -1;
+    return true;
+  }
+  if (value->IsNumber()) {
+    priority = Nan::To<int32_t>(value).FromJust();
+    return priority >= ThreadPool::Interactive && priority <= ThreadPool::Background;
+  }
+  return false;
+}
+
+void ThreadPoolSetPriority(const FunctionCallbackInfo<Value>& info) {
+  Nan::HandleScope scope;
+
+  int priority;
+  if (info.Length() == 0 || !ThreadPoolPriorityFromValue(info[0], priority)) {
+    return Nan::ThrowError("Priority must be one of NodeGit.THREAD_POOL_PRIORITY or null.");
+  }
+
+  libgit2ThreadPool.SetCurrentPriority(priority);
+}
+
+void ThreadPoolGetPriority(const FunctionCallbackInfo<Value>& info) {
+  ThreadPool::Priority priority;
+  if (libgit2ThreadPool.GetCurrentPriority(priority)) {
+    info.GetReturnValue().Set(Nan::New((int)priority));
+  } else {
+    info.GetReturnValue().Set(Nan::Null());
+  }
+}
+
+void ThreadPoolSetRepositoryPriority(const FunctionCallbackInfo<Value>& info) {
+  Nan::HandleScope scope;
+
+  if (info.Length() == 0 || !info[0]->IsObject()) {
+    return Nan::ThrowError("Repository is required.");
+  }
+
+  int priority;
+  if (info.Length() == 1 || !ThreadPoolPriorityFromValue(info[1], priority)) {
+    return Nan::ThrowError("Priority must be one of NodeGit.THREAD_POOL_PRIORITY or null.");
+  }
+
+  git_repository *repo = Nan::ObjectWrap::Unwrap<GitRepository>(Nan::To<v8::Object>(info[0]).ToLocalChecked())->GetValue();
+  libgit2ThreadPool.SetOwnerPriority(repo, priority);
+}
+
+void ThreadPoolSetReservedWorkers(const FunctionCallbackInfo<Value>& info) {
+  Nan::HandleScope scope;
+
+  if (info.Length() == 0 || !info[0]->IsNumber()) {
+    return Nan::ThrowError("Reserved workers is required and must be a Number.");
+  }
+
+  if (!libgit2ThreadPool.SetReservedWorkers(Nan::To<int32_t>(info[0]).FromJust())) {
+    return Nan::ThrowError("Reserved workers must be at least 0 and less than the thread pool size.");
+  }
+}
+
+void ThreadPoolGetReservedWorkers(const FunctionCallbackInfo<Value>& info) {
+  info.GetReturnValue().Set(Nan::New(libgit2ThreadPool.GetReservedWorkers()));
+}
+
+void ThreadPoolSetAffinity(const FunctionCallbackInfo<Value>& info) {
+  Nan::HandleScope scope;
+
+  if (info.Length() == 0 || !info[0]->IsBoolean()) {
+    return Nan::ThrowError("Affinity is required and must be a Boolean.");
+  }
+
+  libgit2ThreadPool.SetAffinityScheduling(Nan::To<bool>(info[0]).FromJust());
+}
+
+void ThreadPoolGetAffinity(const FunctionCallbackInfo<Value>& info) {
+  info.GetReturnValue().Set(Nan::New(libgit2ThreadPool.GetAffinityScheduling()));
+}
+
+void ThreadPoolGetStats(const FunctionCallbackInfo<Value>& info) {
+  const char *priorityNames[ThreadPool::PriorityCount] = { "interactive", "bulk", "background" };
+
+  // return a plain JS object with one entry per priority
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  for (int i = 0; i < ThreadPool::PriorityCount; i++) {
+    ThreadPool::PriorityStats stats = libgit2ThreadPool.GetPriorityStats((ThreadPool::Priority)i);
+    v8::Local<v8::Object> priorityResult = Nan::New<v8::Object>();
+    Nan::Set(priorityResult, Nan::New("queued").ToLocalChecked(), Nan::New(stats.queuedCount));
+    Nan::Set(priorityResult, Nan::New("started").ToLocalChecked(), Nan::New<v8::Number>((double)stats.startedCount));
+    Nan::Set(priorityResult, Nan::New("averageWaitMs").ToLocalChecked(), Nan::New<v8::Number>(
+      stats.startedCount ? stats.totalWaitTime / 1e6 / stats.startedCount : 0
+    ));
+    Nan::Set(priorityResult, Nan::New("maxWaitMs").ToLocalChecked(), Nan::New<v8::Number>(stats.maxWaitTime / 1e6));
+    Nan::Set(result, Nan::New(priorityNames[i]).ToLocalChecked(), priorityResult);
+  }
   info.GetReturnValue().Set(result);
 }
 
+void ObjectPoolGetStats(const FunctionCallbackInfo<Value>& info) {
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  Nan::Set(result, Nan::New("allocated").ToLocalChecked(), Nan::New<v8::Number>((double)objectPoolStats.allocatedCount));
+  Nan::Set(result, Nan::New("reused").ToLocalChecked(), Nan::New<v8::Number>((double)objectPoolStats.reusedCount));
+  Nan::Set(result, Nan::New("recycled").ToLocalChecked(), Nan::New<v8::Number>((double)objectPoolStats.recycledCount));
+  Nan::Set(result, Nan::New("freed").ToLocalChecked(), Nan::New<v8::Number>((double)objectPoolStats.freedCount));
+  info.GetReturnValue().Set(result);
+}
+
+void CallStatsSetEnabled(const FunctionCallbackInfo<Value>& info) {
+  if (info.Length() == 0 || !info[0]->IsBoolean()) {
+    return Nan::ThrowError("Enabled must be a Boolean.");
+  }
+
+  CallStats::SetEnabled(Nan::To<bool>(info[0]).FromJust());
+}
+
+void CallStatsIsEnabled(const FunctionCallbackInfo<Value>& info) {
+  info.GetReturnValue().Set(Nan::New(CallStats::IsEnabled()));
+}
+
+void CallStatsGet(const FunctionCallbackInfo<Value>& info) {
+  info.GetReturnValue().Set(CallStats::ToJavascript());
+}
+
+void CallStatsReset(const FunctionCallbackInfo<Value>& info) {
+  CallStats::Reset();
+}
+
 static uv_mutex_t *opensslMutexes;
 
 void OpenSSL_LockingCallback(int mode, int type, const char *, int) {
@@ -115,6 +301,7 @@ void OpenSSL_ThreadSetup() {
 }
 
 ThreadPool libgit2ThreadPool(10, uv_default_loop());
+ObjectPoolStats objectPoolStats;
 
 extern "C" void init(v8::Local<v8::Object> target) {
   // Initialize thread safety in openssl and libssh2
@@ -141,6 +328,25 @@ extern "C" void init(v8::Local<v8::Object> target) {
   NODE_SET_METHOD(target, "setThreadSafetyStatus", LockMasterSetStatus);
   NODE_SET_METHOD(target, "getThreadSafetyStatus", LockMasterGetStatus);
   NODE_SET_METHOD(target, "getThreadSafetyDiagnostics", LockMasterGetDiagnostics);
+  NODE_SET_METHOD(target, "setThreadSafetyReadWriteLocking", LockMasterSetReadWriteLocking);
+  NODE_SET_METHOD(target, "getThreadSafetyReadWriteLocking", LockMasterGetReadWriteLocking);
+  NODE_SET_METHOD(target, "setThreadPoolSize", ThreadPoolSetSize);
+  NODE_SET_METHOD(target, "getThreadPoolSize", ThreadPoolGetSize);
+  NODE_SET_METHOD(target, "setThreadPoolCompletionBudget", ThreadPoolSetCompletionBudget);
+  NODE_SET_METHOD(target, "getThreadPoolCompletionBudget", ThreadPoolGetCompletionBudget);
+  NODE_SET_METHOD(target, "setThreadPoolPriority", ThreadPoolSetPriority);
+  NODE_SET_METHOD(target, "getThreadPoolPriority", ThreadPoolGetPriority);
+  NODE_SET_METHOD(target, "setRepositoryThreadPoolPriority", ThreadPoolSetRepositoryPriority);
+  NODE_SET_METHOD(target, "setThreadPoolReservedWorkers", ThreadPoolSetReservedWorkers);
+  NODE_SET_METHOD(target, "getThreadPoolReservedWorkers", ThreadPoolGetReservedWorkers);
+  NODE_SET_METHOD(target, "setThreadPoolAffinity", ThreadPoolSetAffinity);
+  NODE_SET_METHOD(target, "getThreadPoolAffinity", ThreadPoolGetAffinity);
+  NODE_SET_METHOD(target, "getThreadPoolStats", ThreadPoolGetStats);
+  NODE_SET_METHOD(target, "getObjectPoolStats", ObjectPoolGetStats);
+  NODE_SET_METHOD(target, "setStatsEnabled", CallStatsSetEnabled);
+  NODE_SET_METHOD(target, "isStatsEnabled", CallStatsIsEnabled);
+  NODE_SET_METHOD(target, "getStats", CallStatsGet);
+  NODE_SET_METHOD(target, "resetStats", CallStatsReset);
 
   v8::Local<v8::Object> threadSafety = Nan::New<v8::Object>();
   Nan::Set(threadSafety, Nan::New("DISABLED").ToLocalChecked(), Nan::New((int)LockMaster::Disabled));
@@ -149,6 +355,13 @@ extern "C" void init(v8::Local<v8::Object> target) {
 
   Nan::Set(target, Nan::New("THREAD_SAFETY").ToLocalChecked(), threadSafety);
 
+  v8::Local<v8::Object> threadPoolPriority = Nan::New<v8::Object>();
+  Nan::Set(threadPoolPriority, Nan::New("INTERACTIVE").ToLocalChecked(), Nan::New((int)ThreadPool::Interactive));
+  Nan::Set(threadPoolPriority, Nan::New("BULK").ToLocalChecked(), Nan::New((int)ThreadPool::Bulk));
+  Nan::Set(threadPoolPriority, Nan::New("BACKGROUND").ToLocalChecked(), Nan::New((int)ThreadPool::Background));
+
+  Nan::Set(target, Nan::New("THREAD_POOL_PRIORITY").ToLocalChecked(), threadPoolPriority);
+
   LockMaster::Initialize();
 }
 
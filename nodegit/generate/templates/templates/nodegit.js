@@ -92,6 +92,7 @@ var importExtension = function(name) {
 // Load up utils
 rawApi.Utils = {};
 require("./utils/lookup_wrapper");
+require("./utils/lookup_many_wrapper");
 require("./utils/normalize_options");
 require("./utils/shallow_clone");
 require("./utils/normalize_fetch_options");
@@ -140,3 +141,17 @@ exports.version = require("../package").version;
 
 // Expose Promise implementation.
 exports.Promise = Promise;
+
+// Queues the asynchronous calls made synchronously by fn with the given
+// thread pool priority. Calls made later on, e.g. in promise callbacks,
+// are not affected.
+exports.withThreadPoolPriority = function(priority, fn) {
+  var previousPriority = rawApi.getThreadPoolPriority();
+  rawApi.setThreadPoolPriority(priority);
+  try {
+    return fn();
+  }
+  finally {
+    rawApi.setThreadPoolPriority(previousPriority);
+  }
+};
@@ -53,25 +53,57 @@ class {{ cppClassName }} : public NodeGitWrapper<{{ cppClassName }}Traits> {
 
           static void {{ field.name }}_async(void *baton);
           static void {{ field.name }}_promiseCompleted(bool isFulfilled, AsyncBaton *_baton, v8::Local<v8::Value> result);
+          {% if field.return.coalescable %}
+            static void {{ field.name }}_coalescedAsync(void *instance);
+            static void {{ field.name }}_coalescedCompleted(AsyncBaton *baton);
+          {% endif %}
           {% if field.return.type == 'void' %}
             struct {{ field.name|titleCase }}Baton : public AsyncBatonWithNoResult {
               {% each field.args|argsInfo as arg %}
                 {{ arg.cType }} {{ arg.name }};
               {% endeach %}
+              {% if field.return.coalescable %}
+                // coalesced calls own copies of their arguments
+                bool isCoalesced;
+              {% endif %}
 
               {{ field.name|titleCase }}Baton()
-                : AsyncBatonWithNoResult() {
+                : AsyncBatonWithNoResult(){% if field.return.coalescable %}, isCoalesced(false){% endif %} {
                 }
+              {% if field.return.coalescable %}
+
+                ~{{ field.name|titleCase }}Baton() {
+                  if (isCoalesced) {
+                    {% each field.args|argsInfo as arg %}
+                      CoalescedFree({{ arg.name }});
+                    {% endeach %}
+                  }
+                }
+              {% endif %}
             };
           {% else %}
             struct {{ field.name|titleCase }}Baton : public AsyncBatonWithResult<{{ field.return.type }}> {
               {% each field.args|argsInfo as arg %}
                 {{ arg.cType }} {{ arg.name }};
               {% endeach %}
+              {% if field.return.coalescable %}
+                // coalesced calls own copies of their arguments
+                bool isCoalesced;
+              {% endif %}
 
               {{ field.name|titleCase }}Baton(const {{ field.return.type }} &defaultResult)
-                : AsyncBatonWithResult<{{ field.return.type }}>(defaultResult) {
+                : AsyncBatonWithResult<{{ field.return.type }}>(defaultResult){% if field.return.coalescable %}, isCoalesced(false){% endif %} {
+                }
+              {% if field.return.coalescable %}
+
+                ~{{ field.name|titleCase }}Baton() {
+                  if (isCoalesced) {
+                    {% each field.args|argsInfo as arg %}
+                      CoalescedFree({{ arg.name }});
+                    {% endeach %}
+                  }
                 }
+              {% endif %}
             };
           {% endif %}
           static {{ cppClassName }} * {{ field.name }}_getInstanceFromBaton (
@@ -20,9 +20,18 @@ Blob.lookup = LookupWrapper(Blob);
 /**
  * Retrieve the content of the Blob.
  *
+ * With `zeroCopy` the Buffer shares the blob's memory instead of copying it,
+ * and keeps that memory alive until the Buffer is garbage collected. Such a
+ * Buffer must not be modified.
+ *
+ * @param {Object} [options]
+ * @param {Boolean} [options.zeroCopy] Don't copy the content.
  * @return {Buffer} Contents as a buffer.
  */
-Blob.prototype.content = function() {
+Blob.prototype.content = function(options) {
+  if (options && options.zeroCopy) {
+    return this.rawcontentBuffer();
+  }
   return this.rawcontent().toBuffer(this.rawsize());
 };
 
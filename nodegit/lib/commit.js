@@ -3,8 +3,10 @@ var fp = require("lodash/fp");
 var NodeGit = require("../");
 var Commit = NodeGit.Commit;
 var LookupWrapper = NodeGit.Utils.lookupWrapper;
+var LookupManyWrapper = NodeGit.Utils.lookupManyWrapper;
 
 var _amend = Commit.prototype.amend;
+var _lookupMany = Commit.lookupMany;
 var _parent = Commit.prototype.parent;
 
 /**
@@ -16,6 +18,34 @@ var _parent = Commit.prototype.parent;
  */
 Commit.lookup = LookupWrapper(Commit);
 
+/**
+ * Retrieves many commits in a single asynchronous call. Commits that don't
+ * exist are returned as null.
+ * @async
+ * @param {Repository} repo The repo that the commits live in
+ * @param {Array<String|Oid>} oids The commits to lookup
+ * @param {Object} [options]
+ * @param {Number} [options.chunkSize] Look the commits up this many at a time
+ * @param {Function} [options.onChunk] Called with each chunk of commits and
+ *                                     its offset as it is looked up. If it
+ *                                     returns a promise, the next chunk is
+ *                                     looked up once it resolves. If given,
+ *                                     the promise resolves to undefined.
+ * @return {Array<Commit>}
+ */
+Commit.lookupMany = function(repo, oids, options) {
+  return LookupManyWrapper(function(chunk) {
+    return _lookupMany(repo, chunk).then(function(commits) {
+      commits.forEach(function(commit) {
+        if (commit) {
+          commit.repo = repo;
+        }
+      });
+      return commits;
+    });
+  })(oids, options);
+};
+
 /**
  * Amend a commit
  * @async
@@ -104,10 +104,65 @@ Diff.prototype.findSimilar = function(opts) {
 /**
  * Retrieve patches in this difflist
  *
+ * Large diffs are split across several threads. With a chunkSize, patches
+ * are generated and handed to onChunk a chunk at a time, so only one chunk
+ * is held in memory.
+ *
  * @async
+ * @param {Object} [options]
+ * @param {Number} [options.chunkSize] Number of deltas to generate patches
+ *                                     for at once
+ * @param {Function} [options.onChunk] Called with every chunk of patches and
+ *                                     the index of its first delta, in delta
+ *                                     order. If it returns a promise, the
+ *                                     next chunk is generated once it
+ *                                     resolves. When given, the promise
+ *                                     resolves to undefined
+ * @param {Number} [options.threads] Maximum number of threads to generate a
+ *                                   chunk with, 1 to generate it serially
+ * @param {Boolean} [options.lazy] Copy the hunks and lines of a patch only
+ *                                 once they are asked for. Until then the
+ *                                 patch keeps the contents of its files
  * @return {Array<ConvenientPatch>} a promise that resolves to an array of
  *                                      ConvenientPatches
  */
-Diff.prototype.patches = function() {
-  return Patch.convenientFromDiff(this);
+Diff.prototype.patches = function(options) {
+  var diff = this;
+
+  if (!options) {
+    return Patch.convenientFromDiff(diff);
+  }
+
+  var numDeltas = diff.numDeltas();
+  var chunkSize = options.chunkSize || numDeltas || 1;
+  var onChunk = options.onChunk;
+  var results = [];
+
+  function patchesChunk(start) {
+    if (start >= numDeltas && start > 0) {
+      return Promise.resolve();
+    }
+
+    return Patch.convenientFromDiff(diff, {
+      start: start,
+      count: chunkSize,
+      threads: options.threads,
+      lazy: options.lazy
+    })
+      .then(function(patches) {
+        if (typeof onChunk === "function") {
+          // the next chunk waits for onChunk, so a slow consumer
+          // holds back generation
+          return onChunk(patches, start);
+        }
+        Array.prototype.push.apply(results, patches);
+      })
+      .then(function() {
+        return patchesChunk(start + chunkSize);
+      });
+  }
+
+  return patchesChunk(0).then(function() {
+    return typeof onChunk === "function" ? undefined : results;
+  });
 };
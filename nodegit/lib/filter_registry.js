@@ -8,6 +8,9 @@ var _unregister = FilterRegistry.unregister;
 
 // register should add filter by name to dict and return
 // Override FilterRegistry.register to normalize Filter
+//
+// `check` is optional, without it the filter is applied to every file
+// matching its attributes, which saves a round trip to JavaScript per file.
 FilterRegistry.register = function(name, filter, priority, callback) {
   // setting default value of attributes
   if (filter.attributes === undefined) {
@@ -16,9 +19,9 @@ FilterRegistry.register = function(name, filter, priority, callback) {
 
   filter = normalizeOptions(filter, NodeGit.Filter);
 
-  if (!filter.check || !filter.apply) {
+  if (!filter.apply) {
     return callback(new Error(
-      "ERROR: please provide check and apply callbacks for filter"
+      "ERROR: please provide an apply callback for filter"
     ));
   }
 
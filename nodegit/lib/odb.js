@@ -2,7 +2,10 @@ var NodeGit = require("../");
 
 var Odb = NodeGit.Odb;
 
+var LookupManyWrapper = NodeGit.Utils.lookupManyWrapper;
+
 var _read = Odb.prototype.read;
+var _readMany = Odb.prototype.readMany;
 
 Odb.prototype.read = function(oid, callback) {
   return _read.call(this, oid).then(function(odbObject) {
@@ -13,3 +16,21 @@ Odb.prototype.read = function(oid, callback) {
     return odbObject;
   }, callback);
 };
+
+/**
+ * Reads many objects in a single asynchronous call. Objects that don't exist
+ * are returned as null.
+ * @async
+ * @param {Array<String|Oid>} oids The objects to read
+ * @param {Object} [options]
+ * @param {Number} [options.chunkSize] Read the objects this many at a time
+ * @param {Function} [options.onChunk] Called with each chunk of objects and
+ *                                     its offset as it is read. If it returns
+ *                                     a promise, the next chunk is read once
+ *                                     it resolves. If given, the promise
+ *                                     resolves to undefined.
+ * @return {Array<OdbObject>}
+ */
+Odb.prototype.readMany = function(oids, options) {
+  return LookupManyWrapper(_readMany.bind(this))(oids, options);
+};
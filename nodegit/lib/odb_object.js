@@ -2,6 +2,24 @@ var NodeGit = require("../");
 
 var OdbObject = NodeGit.OdbObject;
 
+/**
+ * Retrieve the data of the OdbObject.
+ *
+ * With `zeroCopy` the Buffer shares the object's memory instead of copying
+ * it, and keeps that memory alive until the Buffer is garbage collected. Such
+ * a Buffer must not be modified.
+ *
+ * @param {Object} [options]
+ * @param {Boolean} [options.zeroCopy] Don't copy the data.
+ * @return {Buffer} Data as a buffer.
+ */
+OdbObject.prototype.content = function(options) {
+  if (options && options.zeroCopy) {
+    return this.dataBuffer();
+  }
+  return this.data().toBuffer(this.size());
+};
+
 OdbObject.prototype.toString = function(size) {
   size = size || this.size();
 
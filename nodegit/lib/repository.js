@@ -1866,6 +1866,17 @@ Repository.prototype.mergeheadForeach = function(callback) {
   return _mergeheadForeach.call(this, callback, null);
 };
 
+/**
+ * Sets the thread pool priority of asynchronous calls made on behalf of this
+ * repository, unless a priority is set with NodeGit.withThreadPoolPriority.
+ *
+ * @param {NodeGit.THREAD_POOL_PRIORITY|null} priority null to reset to the
+ *                                                     default priority
+ */
+Repository.prototype.setThreadPoolPriority = function(priority) {
+  NodeGit.setRepositoryThreadPoolPriority(this, priority);
+};
+
 /**
  * Stages or unstages line selection of a specified file
  *
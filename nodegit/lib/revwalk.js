@@ -19,8 +19,22 @@ var _sorting = Revwalk.prototype.sorting;
  */
 var fileHistoryWalk = Revwalk.prototype.fileHistoryWalk;
 /**
+ * The returned array has a `reachedEndOfHistory` property. When it is false,
+ * it also has a `cursor` property that can be passed to `fileHistoryWalk` on
+ * a new Revwalk, with the same sorting and nothing pushed, to get the next
+ * page of the history. The cursor keeps the commits pushed on and hidden from
+ * the first Revwalk.
+ *
  * @param {String} filePath
  * @param {Number} max_count
+ * @param {Object} options
+ * @param {Object} options.cursor the cursor returned by the previous page
+ * @param {Boolean} options.limitToDirectory only diff the directory of the
+ *                                           file to detect renames, renames
+ *                                           from other directories are
+ *                                           reported as additions
+ * @param {Boolean} options.useCache reuse the history of commits walked
+ *                                   before (default: true)
  * @async
  * @return {Array<historyEntry>}
  */
@@ -90,6 +104,167 @@ Revwalk.prototype.getCommitsUntil = function(checkFn) {
   });
 };
 
+/**
+ * Walk the history in chunks of commits. Each chunk is one call to
+ * `commitWalk`, walked and looked up on a worker thread. While one chunk is
+ * being consumed the next one is walked, and no further, so memory use stays
+ * bounded by two chunks however long the history is.
+ *
+ * The returned async iterator (usable with `for await` where supported)
+ * yields arrays of commits. Only one iterator should walk a revwalk at a time.
+ * Since a chunk is walked ahead, stopping early (`return`, or `break` in
+ * `for await`) leaves the revwalk past the commits handed out: the chunk
+ * walked ahead is dropped, and walking on resumes after it.
+ *
+ * @param {Object} [options]
+ * @param {Number} [options.chunkSize] commits per chunk (default: 100)
+ * @param {Boolean} [options.returnPlainObjects] yield plain objects instead of
+ *                                               Commits, see commitWalk
+ * @return {Object} an async iterator of Array<Commit>
+ */
+Revwalk.prototype.commitChunks = function(options) {
+  options = options || {};
+  var walker = this;
+  var repo = this.repo;
+  var chunkSize = options.chunkSize || 100;
+  var walkOptions = { returnPlainObjects: !!options.returnPlainObjects };
+  var done = false;
+  // the chunk being walked ahead of the consumer
+  var pending = null;
+  // the last result handed out, so that overlapping calls to next are
+  // answered in order and never walk concurrently
+  var last = Promise.resolve();
+
+  function walkChunk() {
+    var chunk = walker.commitWalk(chunkSize, walkOptions)
+      .then(function(commits) {
+        if (!walkOptions.returnPlainObjects) {
+          commits.forEach(function(commit) {
+            commit.repo = repo;
+          });
+        }
+        return commits;
+      });
+    // errors are reported by the call to next that consumes the chunk
+    chunk.catch(function() {});
+    return chunk;
+  }
+
+  function nextChunk() {
+    if (done) {
+      return { value: undefined, done: true };
+    }
+
+    var chunk = pending || walkChunk();
+    pending = null;
+    return chunk.then(function(commits) {
+      if (done || !commits.length) {
+        done = true;
+        return { value: undefined, done: true };
+      }
+
+      if (commits.length < chunkSize) {
+        done = true;
+      } else {
+        pending = walkChunk();
+      }
+      return { value: commits, done: false };
+    }, function(error) {
+      done = true;
+      throw error;
+    });
+  }
+
+  var iterator = {
+    next: function() {
+      last = last.then(nextChunk, nextChunk);
+      return last;
+    },
+    return: function() {
+      var finished = { value: undefined, done: true };
+      var chunk = pending;
+      done = true;
+      pending = null;
+      // let a chunk walked ahead finish before the revwalk is used again.
+      // Its commits are dropped, the revwalk has moved past them for good.
+      function finish() {
+        return finished;
+      }
+      return chunk ? chunk.then(finish, finish) : Promise.resolve(finished);
+    }
+  };
+
+  if (typeof Symbol === "function" && Symbol.asyncIterator) {
+    iterator[Symbol.asyncIterator] = function() {
+      return this;
+    };
+  }
+
+  return iterator;
+};
+
+/**
+ * Walk the history one commit at a time, backed by `commitChunks`, so that
+ * commits are walked on a worker thread in chunks rather than one
+ * asynchronous call per commit.
+ *
+ * The returned async iterator (usable with `for await` where supported)
+ * yields commits. A Revwalk is itself async iterable with the default options.
+ *
+ * @param {Object} [options] see commitChunks
+ * @return {Object} an async iterator of Commit
+ */
+Revwalk.prototype.commits = function(options) {
+  var chunks = this.commitChunks(options);
+  var chunk = [];
+  var index = 0;
+
+  function nextCommit() {
+    if (index < chunk.length) {
+      return { value: chunk[index++], done: false };
+    }
+
+    return chunks.next().then(function(result) {
+      if (result.done) {
+        chunk = [];
+        index = 0;
+        return result;
+      }
+
+      chunk = result.value;
+      index = 0;
+      return nextCommit();
+    });
+  }
+
+  var last = Promise.resolve();
+  var iterator = {
+    next: function() {
+      last = last.then(nextCommit, nextCommit);
+      return last;
+    },
+    return: function() {
+      chunk = [];
+      index = 0;
+      return chunks.return();
+    }
+  };
+
+  if (typeof Symbol === "function" && Symbol.asyncIterator) {
+    iterator[Symbol.asyncIterator] = function() {
+      return this;
+    };
+  }
+
+  return iterator;
+};
+
+if (typeof Symbol === "function" && Symbol.asyncIterator) {
+  Revwalk.prototype[Symbol.asyncIterator] = function() {
+    return this.commits();
+  };
+}
+
 /**
  * Set the sort order for the revwalk. This function takes variable arguments
  * like `revwalk.sorting(NodeGit.RevWalk.Topological, NodeGit.RevWalk.Reverse).`
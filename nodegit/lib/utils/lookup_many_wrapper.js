@@ -0,0 +1,45 @@
+var NodeGit = require("../../");
+
+/**
+* Wraps a bulk lookup so that its results can optionally be delivered in
+* chunks. Every chunk is looked up in a single asynchronous call, and the next
+* chunk is only looked up once the previous one has been handed to `onChunk`
+* and the promise it returns, if any, has resolved. An empty array of oids
+* resolves right away.
+* @param {Function} lookupManyFunction The function that looks up an array of
+*                                      oids and resolves to an array of objects.
+* @return {Function}
+*/
+function lookupManyWrapper(lookupManyFunction) {
+  return function(oids, options) {
+    options = options || {};
+
+    var chunkSize = options.chunkSize || oids.length || 1;
+    var onChunk = options.onChunk;
+    var results = [];
+
+    function lookupChunk(offset) {
+      if (offset >= oids.length) {
+        return Promise.resolve();
+      }
+
+      var chunk = oids.slice(offset, offset + chunkSize);
+      return lookupManyFunction(chunk)
+        .then(function(objects) {
+          if (typeof onChunk === "function") {
+            return onChunk(objects, offset);
+          }
+          Array.prototype.push.apply(results, objects);
+        })
+        .then(function() {
+          return lookupChunk(offset + chunkSize);
+        });
+    }
+
+    return lookupChunk(0).then(function() {
+      return typeof onChunk === "function" ? undefined : results;
+    });
+  };
+}
+
+NodeGit.Utils.lookupManyWrapper = lookupManyWrapper;
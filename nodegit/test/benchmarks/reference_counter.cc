@@ -0,0 +1,97 @@
+// Compares ReferenceCounter against a single mutex-guarded map, counting and
+// releasing pointers from several threads the way wrappers are created for
+// looked up objects and freed again. Only libuv is required:
+//
+//   g++ -std=c++11 -O2 -I<path to uv.h> -o reference_counter_benchmark
+//     test/benchmarks/reference_counter.cc
+//     generate/templates/manual/src/reference_counter.cc -luv -lpthread
+//   ./reference_counter_benchmark [operations per thread] [pointers per thread]
+
+#include <uv.h>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#include "../../generate/templates/manual/include/reference_counter.h"
+
+// The previous ReferenceCounter, with the one lock it needs to be thread safe
+class SingleMapReferenceCounter {
+  static std::unordered_map<void *, unsigned long> referenceCountByPointer;
+  static uv_mutex_t mutex;
+
+public:
+  static void Initialize() {
+    uv_mutex_init(&mutex);
+  }
+
+  static void incrementCountForPointer(void *ptr) {
+    uv_mutex_lock(&mutex);
+    referenceCountByPointer[ptr]++;
+    uv_mutex_unlock(&mutex);
+  }
+
+  static unsigned long decrementCountForPointer(void *ptr) {
+    uv_mutex_lock(&mutex);
+    unsigned long referenceCount = --referenceCountByPointer[ptr];
+    if (!referenceCount) {
+      referenceCountByPointer.erase(ptr);
+    }
+    uv_mutex_unlock(&mutex);
+    return referenceCount;
+  }
+};
+
+std::unordered_map<void *, unsigned long> SingleMapReferenceCounter::referenceCountByPointer;
+uv_mutex_t SingleMapReferenceCounter::mutex;
+
+static int operations;
+static int pointersPerThread;
+
+template<typename Counter>
+static void CountPointers(void *pointers) {
+  std::vector<char> &objects = *static_cast<std::vector<char> *>(pointers);
+  for (int i = 0; i < operations; i++) {
+    // every pointer is seen twice, like a repository that is opened and
+    // then returned again as the owner of a commit
+    void *ptr = &objects[(i % pointersPerThread) * 8];
+    Counter::incrementCountForPointer(ptr);
+    Counter::incrementCountForPointer(ptr);
+    Counter::decrementCountForPointer(ptr);
+    Counter::decrementCountForPointer(ptr);
+  }
+}
+
+template<typename Counter>
+static void Run(const char *name, int numberOfThreads) {
+  std::vector<std::vector<char> > objects(numberOfThreads, std::vector<char>(pointersPerThread * 8));
+  std::vector<uv_thread_t> threads(numberOfThreads);
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < numberOfThreads; i++) {
+    uv_thread_create(&threads[i], CountPointers<Counter>, &objects[i]);
+  }
+  for (int i = 0; i < numberOfThreads; i++) {
+    uv_thread_join(&threads[i]);
+  }
+  uint64_t elapsed = uv_hrtime() - start;
+
+  double totalOperations = 4.0 * operations * numberOfThreads;
+  printf("%-12s threads=%-3d %8.1f ms %12.0f ops/s\n",
+    name, numberOfThreads, elapsed / 1e6, totalOperations / (elapsed / 1e9));
+}
+
+int main(int argc, char **argv) {
+  operations = argc > 1 ? atoi(argv[1]) : 1000000;
+  pointersPerThread = argc > 2 ? atoi(argv[2]) : 64;
+
+  SingleMapReferenceCounter::Initialize();
+
+  int threadCounts[] = { 1, 2, 4, 8, 16 };
+  for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+    Run<SingleMapReferenceCounter>("single-map", threadCounts[i]);
+    Run<ReferenceCounter>("sharded", threadCounts[i]);
+  }
+
+  return 0;
+}
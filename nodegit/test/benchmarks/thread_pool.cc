@@ -0,0 +1,151 @@
+// Compares the throughput of ThreadPool against the single mutex-guarded
+// queue it replaced. Only libuv is required:
+//
+//   g++ -std=c++11 -O2 -I<path to uv.h> -o thread_pool_benchmark
+//     test/benchmarks/thread_pool.cc
+//     generate/templates/manual/src/thread_pool.cc -luv -lpthread
+//   ./thread_pool_benchmark [jobs] [spin iterations per job]
+
+#include <uv.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+
+#include "../../generate/templates/manual/include/thread_pool.h"
+
+// The previous ThreadPool: one queue behind one mutex and a semaphore
+class SingleQueueThreadPool {
+  struct Work {
+    ThreadPool::Callback workCallback;
+    ThreadPool::Callback completionCallback;
+    void *data;
+  };
+
+  std::queue<Work> workQueue;
+  uv_mutex_t workMutex;
+  uv_sem_t workSemaphore;
+  int workInProgressCount;
+
+  std::queue<Work> loopQueue;
+  uv_mutex_t loopMutex;
+  uv_async_t loopAsync;
+
+  static void RunEventQueue(void *threadPool) {
+    SingleQueueThreadPool *self = static_cast<SingleQueueThreadPool *>(threadPool);
+    for ( ; ; ) {
+      uv_sem_wait(&self->workSemaphore);
+      uv_mutex_lock(&self->workMutex);
+      Work work = self->workQueue.front();
+      self->workQueue.pop();
+      uv_mutex_unlock(&self->workMutex);
+
+      (*work.workCallback)(work.data);
+
+      uv_mutex_lock(&self->loopMutex);
+      bool queueWasEmpty = self->loopQueue.empty();
+      self->loopQueue.push(work);
+      if (queueWasEmpty) {
+        uv_async_send(&self->loopAsync);
+      }
+      uv_mutex_unlock(&self->loopMutex);
+    }
+  }
+
+  static void RunLoopCallbacks(uv_async_t *handle) {
+    SingleQueueThreadPool *self = static_cast<SingleQueueThreadPool *>(handle->data);
+    uv_mutex_lock(&self->loopMutex);
+    Work work = self->loopQueue.front();
+    uv_mutex_unlock(&self->loopMutex);
+
+    (*work.completionCallback)(work.data);
+
+    uv_mutex_lock(&self->loopMutex);
+    self->loopQueue.pop();
+    if (!self->loopQueue.empty()) {
+      uv_async_send(&self->loopAsync);
+    }
+    uv_mutex_unlock(&self->loopMutex);
+
+    uv_mutex_lock(&self->workMutex);
+    if (!--self->workInProgressCount) {
+      uv_unref((uv_handle_t *)&self->loopAsync);
+    }
+    uv_mutex_unlock(&self->workMutex);
+  }
+
+public:
+  SingleQueueThreadPool(int numberOfThreads, uv_loop_t *loop) : workInProgressCount(0) {
+    uv_mutex_init(&workMutex);
+    uv_sem_init(&workSemaphore, 0);
+    uv_async_init(loop, &loopAsync, RunLoopCallbacks);
+    loopAsync.data = this;
+    uv_unref((uv_handle_t *)&loopAsync);
+    uv_mutex_init(&loopMutex);
+    for (int i = 0; i < numberOfThreads; i++) {
+      uv_thread_t thread;
+      uv_thread_create(&thread, RunEventQueue, this);
+    }
+  }
+
+  void QueueWork(ThreadPool::Callback workCallback, ThreadPool::Callback completionCallback, void *data) {
+    uv_mutex_lock(&workMutex);
+    uv_ref((uv_handle_t *)&loopAsync);
+    Work work = { workCallback, completionCallback, data };
+    workQueue.push(work);
+    workInProgressCount++;
+    uv_mutex_unlock(&workMutex);
+    uv_sem_post(&workSemaphore);
+  }
+};
+
+static int spinIterations;
+static std::atomic<int> workDone;
+static int completionsDone;
+
+static void Work(void *) {
+  volatile int sink = 0;
+  for (int i = 0; i < spinIterations; i++) {
+    sink += i;
+  }
+  workDone++;
+}
+
+static void Completion(void *) {
+  completionsDone++;
+}
+
+template<typename Pool>
+static void Run(const char *name, int numberOfThreads, int jobs) {
+  uv_loop_t *loop = new uv_loop_t;
+  uv_loop_init(loop);
+  Pool *pool = new Pool(numberOfThreads, loop);
+
+  workDone = 0;
+  completionsDone = 0;
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < jobs; i++) {
+    pool->QueueWork(Work, Completion, NULL);
+  }
+  uv_run(loop, UV_RUN_DEFAULT);
+  uint64_t elapsed = uv_hrtime() - start;
+
+  printf("%-14s threads=%-3d jobs=%-8d %8.1f ms %10.0f jobs/s\n",
+    name, numberOfThreads, jobs, elapsed / 1e6, jobs / (elapsed / 1e9));
+
+  // worker threads never exit, so the pool and loop are deliberately leaked
+}
+
+int main(int argc, char **argv) {
+  int jobs = argc > 1 ? atoi(argv[1]) : 200000;
+  spinIterations = argc > 2 ? atoi(argv[2]) : 200;
+
+  int threadCounts[] = { 1, 2, 4, 8, 16 };
+  for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+    Run<SingleQueueThreadPool>("single-queue", threadCounts[i], jobs);
+    Run<ThreadPool>("work-stealing", threadCounts[i], jobs);
+  }
+
+  return 0;
+}
@@ -0,0 +1,245 @@
+// Compares the latency of ThreadPool with and without affinity scheduling on
+// a workload spread over many repositories. Each job reads from the state of
+// its repository, standing in for the mwindow mappings and delta base cache
+// that stay warm when a repository keeps running on the same worker.
+//
+// Two more scenarios check that affinity does not leave work stuck behind a
+// long job on its home worker: a single short job queued right behind a long
+// one for the same repository, and a skewed workload where a quarter of the
+// jobs are on one repository and some of its jobs take milliseconds.
+// Only libuv is required:
+//
+//   g++ -std=c++11 -O2 -I<path to uv.h> -o thread_pool_affinity_benchmark
+//     test/benchmarks/thread_pool_affinity.cc
+//     generate/templates/manual/src/thread_pool.cc -luv -lpthread
+//   ./thread_pool_affinity_benchmark [jobs] [repositories] [KiB per repository]
+
+#include <uv.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../../generate/templates/manual/include/thread_pool.h"
+
+// reads per job, each on a different cache line of the repository's state
+static const int readsPerJob = 4096;
+// jobs in flight at any time, per thread
+static const int jobsInFlightPerThread = 4;
+
+struct Repository {
+  // a random cycle through the cache lines of the state, so that
+  // every read depends on the previous one
+  std::vector<size_t> state;
+};
+
+// in the skewed scenario, the share of the jobs on the first repository,
+// and how many of its jobs are long ones. Those block, like jobs waiting
+// for a slow disk, so that the scenario also shows on a single core.
+static const unsigned hotRepositoryPercent = 25;
+static const unsigned longJobEvery = 50;
+static const uint64_t longJobDuration = 20 * 1000 * 1000;
+
+struct Job {
+  Repository *repository;
+  // where in the state the reads start
+  size_t position;
+  // how long the job keeps reading, 0 for readsPerJob reads
+  uint64_t duration;
+  // whether it sleeps for that long instead, like a job blocked on I/O
+  bool blocking;
+  uint64_t queuedAt;
+  // the result of the reads, so they can't be optimized away
+  size_t result;
+};
+
+static std::vector<Repository> repositories;
+static ThreadPool *pool;
+static int jobsToQueue;
+static bool skewed;
+// latencies of the short jobs
+static std::vector<uint64_t> latencies;
+static unsigned randomState = 1;
+
+static unsigned Random() {
+  randomState = randomState * 1103515245 + 12345;
+  return randomState >> 8;
+}
+
+static void Work(void *data) {
+  Job *job = static_cast<Job *>(data);
+  const std::vector<size_t> &state = job->repository->state;
+  size_t position = job->position;
+  if (job->blocking) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(job->duration));
+  } else if (job->duration) {
+    uint64_t start = uv_hrtime();
+    while (uv_hrtime() - start < job->duration) {
+      for (int i = 0; i < readsPerJob; i++) {
+        position = state[position];
+      }
+    }
+  } else {
+    for (int i = 0; i < readsPerJob; i++) {
+      position = state[position];
+    }
+  }
+  job->result = position;
+}
+
+static void Completion(void *data);
+
+static void QueueJob(Job *job) {
+  job->duration = 0;
+  job->blocking = false;
+  if (skewed && Random() % 100 < hotRepositoryPercent) {
+    job->repository = &repositories[0];
+    if (Random() % longJobEvery == 0) {
+      job->duration = longJobDuration;
+      job->blocking = true;
+    }
+  } else {
+    job->repository = &repositories[Random() % repositories.size()];
+  }
+  job->position = (Random() % job->repository->state.size()) & ~(size_t)7;
+  job->queuedAt = uv_hrtime();
+  jobsToQueue--;
+  pool->QueueWork(Work, Completion, job, ThreadPool::Interactive, job->repository);
+}
+
+static void Completion(void *data) {
+  Job *job = static_cast<Job *>(data);
+  if (!job->duration) {
+    latencies.push_back(uv_hrtime() - job->queuedAt);
+  }
+  if (jobsToQueue > 0) {
+    QueueJob(job);
+  } else {
+    delete job;
+  }
+}
+
+static double Percentile(double percentile) {
+  size_t index = (size_t)(percentile * (latencies.size() - 1));
+  return latencies[index] / 1e3;
+}
+
+static uv_loop_t *NewLoop() {
+  uv_loop_t *loop = new uv_loop_t;
+  uv_loop_init(loop);
+  return loop;
+}
+
+static void Run(int numberOfThreads, bool affinity, int jobs) {
+  uv_loop_t *loop = NewLoop();
+  pool = new ThreadPool(numberOfThreads, loop);
+  pool->SetReservedWorkers(0);
+  pool->SetAffinityScheduling(affinity);
+
+  jobsToQueue = jobs;
+  latencies.clear();
+  latencies.reserve(jobs);
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < numberOfThreads * jobsInFlightPerThread; i++) {
+    QueueJob(new Job);
+  }
+  uv_run(loop, UV_RUN_DEFAULT);
+  uint64_t elapsed = uv_hrtime() - start;
+
+  std::sort(latencies.begin(), latencies.end());
+  printf("%-11s threads=%-3d %8.0f jobs/s  p50 %8.1f us  p90 %8.1f us  p99 %8.1f us\n",
+    affinity ? "affinity" : "no-affinity", numberOfThreads, jobs / (elapsed / 1e9),
+    Percentile(0.5), Percentile(0.9), Percentile(0.99));
+
+  // worker threads never exit, so the pool and loop are deliberately leaked
+}
+
+static Job *shortJob;
+
+static void QueueShortJob(uv_timer_t *timer) {
+  shortJob->queuedAt = uv_hrtime();
+  uv_close((uv_handle_t *)timer, NULL);
+  pool->QueueWork(Work, Completion, shortJob, ThreadPool::Interactive, shortJob->repository);
+}
+
+// Queues a long job, then 1ms later a short job on the same repository,
+// while every other worker is idle. The long job sleeps, so that the loop
+// thread queues the short job on time even on a single core.
+static void RunBehindLongJob(bool affinity) {
+  uv_loop_t *loop = NewLoop();
+  pool = new ThreadPool(4, loop);
+  pool->SetReservedWorkers(0);
+  pool->SetAffinityScheduling(affinity);
+
+  jobsToQueue = 0;
+  latencies.clear();
+
+  Job *longJob = new Job;
+  longJob->repository = &repositories[0];
+  longJob->position = 0;
+  longJob->duration = 500 * 1000 * 1000;
+  longJob->blocking = true;
+  longJob->queuedAt = uv_hrtime();
+  pool->QueueWork(Work, Completion, longJob, ThreadPool::Interactive, longJob->repository);
+
+  shortJob = new Job;
+  shortJob->repository = &repositories[0];
+  shortJob->position = 0;
+  shortJob->duration = 0;
+  shortJob->blocking = false;
+
+  uv_timer_t timer;
+  uv_timer_init(loop, &timer);
+  uv_timer_start(&timer, QueueShortJob, 1, 0);
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  printf("%-11s short job behind a 500ms job: %8.1f us\n",
+    affinity ? "affinity" : "no-affinity", latencies[0] / 1e3);
+}
+
+int main(int argc, char **argv) {
+  int jobs = argc > 1 ? atoi(argv[1]) : 100000;
+  int repositoryCount = argc > 2 ? atoi(argv[2]) : 64;
+  size_t stateSize = (argc > 3 ? atoi(argv[3]) : 512) * 1024;
+
+  // one entry per 64 byte cache line
+  size_t stride = 64 / sizeof(size_t);
+  size_t lines = stateSize / 64;
+  repositories.resize(repositoryCount);
+  for (size_t r = 0; r < repositories.size(); r++) {
+    Repository &repository = repositories[r];
+    std::vector<size_t> order(lines);
+    for (size_t i = 0; i < lines; i++) {
+      order[i] = i * stride;
+    }
+    for (size_t i = lines - 1; i > 0; i--) {
+      std::swap(order[i], order[Random() % (i + 1)]);
+    }
+    repository.state.assign(lines * stride, 0);
+    for (size_t i = 0; i < lines; i++) {
+      repository.state[order[i]] = order[(i + 1) % lines];
+    }
+  }
+
+  int threadCounts[] = { 2, 4, 8, 16 };
+  printf("uniform:\n");
+  for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+    Run(threadCounts[i], false, jobs);
+    Run(threadCounts[i], true, jobs);
+  }
+
+  printf("skewed, with long jobs:\n");
+  skewed = true;
+  for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+    Run(threadCounts[i], false, jobs);
+    Run(threadCounts[i], true, jobs);
+  }
+
+  RunBehindLongJob(false);
+  RunBehindLongJob(true);
+
+  return 0;
+}
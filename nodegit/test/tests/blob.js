@@ -3,6 +3,7 @@ var path = require("path");
 var local = path.join.bind(path, __dirname);
 var fse = require("fs-extra");
 var exec = require("../../utils/execPromise");
+var garbageCollect = require("../utils/garbage_collect.js");
 
 describe("Blob", function() {
   var NodeGit = require("../../");
@@ -106,6 +107,24 @@ describe("Blob", function() {
     assert.ok(Buffer.isBuffer(contents));
   });
 
+  it("can provide content as a buffer without copying it", function() {
+    var contents = this.blob.content({ zeroCopy: true });
+
+    assert.ok(Buffer.isBuffer(contents));
+    assert.equal(contents.length, this.blob.rawsize());
+    assert.ok(contents.equals(this.blob.content()));
+  });
+
+  it("keeps zero-copy content valid after the blob is collected", function() {
+    var expected = this.blob.toString();
+    var contents = this.blob.content({ zeroCopy: true });
+
+    this.blob = null;
+    garbageCollect();
+
+    assert.equal(contents.toString(), expected);
+  });
+
   it("can provide content as a string", function() {
     var contents = this.blob.toString();
 
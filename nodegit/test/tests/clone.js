@@ -194,6 +194,45 @@ describe("Clone", function() {
     });
   });
 
+  it("can clone with coalesced progress", function() {
+    var test = this;
+    var url = "https://github.com/nodegit/test.git";
+    var progressCount = 0;
+    var lastProgress;
+    var cloneFinished = false;
+    var opts = {
+        fetchOpts: {
+          callbacks: {
+            transferProgress: {
+              coalesce: true,
+              callback: function(progress) {
+                assert.ok(
+                  !cloneFinished,
+                  "callback running after clone completion"
+                );
+                progressCount++;
+                // kept past the callback, so it has to own its data
+                lastProgress = progress;
+              }
+            }
+          }
+        }
+    };
+
+    return Clone(url, clonePath, opts).then(function(repo) {
+      assert.ok(repo instanceof Repository);
+      cloneFinished = true;
+      assert.notEqual(progressCount, 0);
+      // the final progress is always delivered
+      assert.equal(
+        lastProgress.receivedObjects(),
+        lastProgress.totalObjects()
+      );
+      assert.equal(lastProgress.indexedDeltas(), lastProgress.totalDeltas());
+      test.repository = repo;
+    });
+  });
+
   it("can clone using nested function", function() {
     var test = this;
     var url = "https://github.com/nodegit/test.git";
@@ -95,6 +95,75 @@ describe("Commit", function() {
     });
   });
 
+  it("can look up many commits at once", function() {
+    var commit = this.commit;
+    var missing = "0000000000000000000000000000000000000001";
+
+    return Commit.lookupMany(this.repository, [oid, commit.id(), missing])
+      .then(function(commits) {
+        assert.equal(commits.length, 3);
+        assert.equal(commits[0].sha(), oid);
+        assert.equal(commits[1].sha(), oid);
+        assert.equal(commits[2], null);
+      });
+  });
+
+  it("can look up many commits in chunks", function() {
+    var repository = this.repository;
+    var chunks = [];
+
+    return this.commit.parent(0)
+      .then(function(parent) {
+        return Commit.lookupMany(repository, [oid, parent.id(), oid], {
+          chunkSize: 2,
+          onChunk: function(commits, offset) {
+            chunks.push({ length: commits.length, offset: offset });
+          }
+        });
+      })
+      .then(function(result) {
+        assert.equal(result, undefined);
+        assert.deepEqual(chunks, [
+          { length: 2, offset: 0 },
+          { length: 1, offset: 2 }
+        ]);
+      });
+  });
+
+  it("waits for onChunk before looking up the next chunk", function() {
+    var inChunk = false;
+
+    return Commit.lookupMany(this.repository, [oid, oid, oid], {
+      chunkSize: 1,
+      onChunk: function() {
+        assert.equal(inChunk, false);
+        inChunk = true;
+        return new Promise(function(resolve) {
+          setTimeout(function() {
+            inChunk = false;
+            resolve();
+          }, 5);
+        });
+      }
+    });
+  });
+
+  it("looks up an empty array of commits", function() {
+    return Commit.lookupMany(this.repository, [])
+      .then(function(commits) {
+        assert.deepEqual(commits, []);
+      });
+  });
+
+  it("rejects oids that are not an Oid or a String", function() {
+    return Commit.lookupMany(this.repository, [oid, { id: oid }])
+      .then(function() {
+        assert.fail("Should not look up a plain object");
+      }, function(err) {
+        assert.ok(err instanceof TypeError);
+      });
+  });
+
   it("has a message", function() {
     assert.equal(this.commit.message(), "Update README.md");
   });
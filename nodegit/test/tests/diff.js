@@ -289,6 +289,133 @@ describe("Diff", function() {
       });
   });
 
+  it("generates the same patches in parallel and serially", function() {
+    var repo = this.repository;
+    var tree = this.masterCommitTree;
+    var diff;
+    var serialPaths;
+
+    function paths(patches) {
+      return patches.map(function(patch) {
+        return patch.newFile().path() + ":" + patch.size();
+      });
+    }
+
+    return Diff.treeToTree(repo, null, tree, null)
+      .then(function(_diff) {
+        diff = _diff;
+        return diff.patches({ threads: 1 });
+      })
+      .then(function(patches) {
+        serialPaths = paths(patches);
+        return diff.patches({ threads: 4 });
+      })
+      .then(function(patches) {
+        assert.deepEqual(paths(patches), serialPaths);
+      });
+  });
+
+  it("can stream patches in chunks", function() {
+    var repo = this.repository;
+    var tree = this.masterCommitTree;
+    var diff;
+    var allPaths;
+    var chunkPaths = [];
+    var offsets = [];
+
+    return Diff.treeToTree(repo, null, tree, null)
+      .then(function(_diff) {
+        diff = _diff;
+        return diff.patches();
+      })
+      .then(function(patches) {
+        allPaths = patches.map(function(patch) {
+          return patch.newFile().path();
+        });
+
+        return diff.patches({
+          chunkSize: 10,
+          onChunk: function(patches, offset) {
+            assert.ok(patches.length <= 10);
+            offsets.push(offset);
+            patches.forEach(function(patch) {
+              chunkPaths.push(patch.newFile().path());
+            });
+          }
+        });
+      })
+      .then(function(result) {
+        assert.equal(result, undefined);
+        assert.deepEqual(chunkPaths, allPaths);
+        assert.deepEqual(offsets.slice(0, 3), [0, 10, 20]);
+      });
+  });
+
+  it("waits for onChunk before generating the next chunk", function() {
+    var tree = this.masterCommitTree;
+    var inChunk = false;
+    var chunks = 0;
+
+    return Diff.treeToTree(this.repository, null, tree, null)
+      .then(function(diff) {
+        return diff.patches({
+          chunkSize: 10,
+          onChunk: function() {
+            assert.ok(!inChunk);
+            inChunk = true;
+            chunks++;
+
+            return new Promise(function(resolve) {
+              setTimeout(function() {
+                inChunk = false;
+                resolve();
+              }, 5);
+            });
+          }
+        });
+      })
+      .then(function() {
+        assert.ok(chunks > 1);
+        assert.ok(!inChunk);
+      });
+  });
+
+  it("can materialize hunks and lines lazily", function() {
+    var diff = this.workdirDiff;
+
+    function linesOf(patches) {
+      return Promise.all(patches.map(function(patch) {
+        return patch.hunks();
+      }))
+        .then(function(listsOfHunks) {
+          return Promise.all(_.flatten(listsOfHunks).map(function(hunk) {
+            return hunk.lines();
+          }));
+        })
+        .then(function(listsOfLines) {
+          return _.flatten(listsOfLines).map(function(line) {
+            return line.origin() + line.content();
+          });
+        });
+    }
+
+    var eagerLines;
+    return diff.patches()
+      .then(linesOf)
+      .then(function(lines) {
+        eagerLines = lines;
+        return diff.patches({ lazy: true });
+      })
+      .then(function(patches) {
+        assert.ok(patches[0].lineStats());
+        return linesOf(patches);
+      })
+      .then(function(lines) {
+        assert.ok(lines.length > 0);
+        assert.deepEqual(lines, eagerLines);
+      });
+  });
+
   it("can diff the initial commit of a repository", function() {
     var repo = this.repository;
     var oid = "99c88fd2ac9c5e385bd1fe119d89c83dce326219"; // First commit
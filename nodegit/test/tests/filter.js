@@ -556,6 +556,38 @@ describe("Filter", function() {
         });
     });
 
+    it("applies filter data on checkout without a check", function() {
+      var test = this;
+      var applied = 0;
+
+      return Registry.register(filterName, {
+        apply: function(to, from, source) {
+          applied++;
+          to.set(tempBuffer, length);
+          return NodeGit.Error.CODE.OK;
+        }
+      }, 0)
+        .then(function(result) {
+          assert.strictEqual(result, 0);
+          fse.writeFileSync(readmePath, "whoa", "utf8");
+          fse.writeFileSync(packageJsonPath, "whoa", "utf8");
+
+          var opts = {
+            checkoutStrategy: Checkout.STRATEGY.FORCE,
+            paths: ["README.md", "package.json"]
+          };
+          return Checkout.head(test.repository, opts);
+        })
+        .then(function() {
+          assert.strictEqual(fse.readFileSync(readmePath, "utf-8"), message);
+          assert.strictEqual(
+            fse.readFileSync(packageJsonPath, "utf-8"),
+            message
+          );
+          assert.strictEqual(applied, 2);
+        });
+    });
+
     // this test is useless on 32 bit CI, because we cannot construct
     // a buffer big enough to test anything of significance :)...
     if (process.arch === "x64") {
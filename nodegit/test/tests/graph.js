@@ -1,5 +1,6 @@
 var assert = require("assert");
 var path = require("path");
+var fse = require("fs-extra");
 var local = path.join.bind(path, __dirname);
 
 describe("Graph", function() {
@@ -61,4 +62,33 @@ describe("Graph", function() {
         assert(~result.message.indexOf("81b06fac"));
       });
   });
+
+  it("gives the same results with a commit-graph file", function() {
+    var repository = this.repository;
+    var graphPath = path.join(
+      repository.path(),
+      "objects",
+      "info",
+      "commit-graph"
+    );
+
+    return repository.writeCommitGraph()
+      .then(function() {
+        assert.ok(fse.existsSync(graphPath));
+        return Graph.aheadBehind(
+          repository,
+          "32789a79e71fbc9e04d3eff7425e1771eb595150",
+          "1729c73906bb8467f4095c2f4044083016b4dfde");
+      })
+      .then(function(result) {
+        assert.equal(result.ahead, 1);
+        assert.equal(result.behind, 1);
+        return fse.remove(graphPath);
+      }, function(error) {
+        return fse.remove(graphPath)
+          .then(function() {
+            throw error;
+          });
+      });
+  });
 });
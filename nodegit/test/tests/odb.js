@@ -1,5 +1,6 @@
 var assert = require("assert");
 var path = require("path");
+var fse = require("fs-extra");
 var local = path.join.bind(path, __dirname);
 
 describe("Odb", function() {
@@ -42,6 +43,28 @@ describe("Odb", function() {
       });
   });
 
+  it("can read many objects at once", function() {
+    var oid = "32789a79e71fbc9e04d3eff7425e1771eb595150";
+    var missing = "0000000000000000000000000000000000000001";
+
+    return this.odb.readMany([oid, Oid.fromString(oid), missing])
+      .then(function(objects) {
+        assert.equal(objects.length, 3);
+        assert.equal(objects[0].type(), Obj.TYPE.COMMIT);
+        assert.equal(objects[1].id().toString(), oid);
+        assert.equal(objects[2], null);
+      });
+  });
+
+  it("rejects oids that are not an Oid or a String", function() {
+    return this.odb.readMany([{}])
+      .then(function() {
+        assert.fail("Should not read a plain object");
+      }, function(err) {
+        assert.ok(err instanceof TypeError);
+      });
+  });
+
   it("can write raw objects to git", function() {
     var obj = "test data";
     var odb = this.odb;
@@ -58,4 +81,41 @@ describe("Odb", function() {
         assert.equal(object.size(), obj.length);
       });
   });
+
+  it("can provide object data without copying it", function() {
+    return this.odb.read("32789a79e71fbc9e04d3eff7425e1771eb595150")
+      .then(function(object) {
+        var data = object.content({ zeroCopy: true });
+
+        assert.ok(Buffer.isBuffer(data));
+        assert.equal(data.length, object.size());
+        assert.ok(data.equals(object.content()));
+        assert.equal(data.toString(), object.toString());
+      });
+  });
+
+  it("can write a multi-pack-index", function() {
+    var odb = this.odb;
+    var midxPath = path.join(
+      this.repo.path(),
+      "objects",
+      "pack",
+      "multi-pack-index"
+    );
+
+    return odb.writeMultiPackIndex()
+      .then(function() {
+        assert.ok(fse.existsSync(midxPath));
+        return odb.read("32789a79e71fbc9e04d3eff7425e1771eb595150");
+      })
+      .then(function(object) {
+        assert.equal(object.type(), Obj.TYPE.COMMIT);
+        return fse.remove(midxPath);
+      }, function(error) {
+        return fse.remove(midxPath)
+          .then(function() {
+            throw error;
+          });
+      });
+  });
 });
@@ -22,4 +22,10 @@ describe("Packbuilder", function() {
 
     assert(packBuilder instanceof Packbuilder);
   });
+
+  it("can be asked to write a bitmap index", function() {
+    var packBuilder = Packbuilder.create(this.repository);
+
+    assert.equal(packBuilder.setWriteBitmap(1), 0);
+  });
 });
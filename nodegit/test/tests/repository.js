@@ -266,6 +266,116 @@ describe("Repository", function() {
       });
   });
 
+  it("can refresh references", function() {
+    return this.repository.refreshReferences()
+      .then(function(result) {
+        assert.ok(result.refs.length > 0);
+        assert.equal(result.refs[0].fullName, result.headRefFullName);
+        assert.equal(result.isIncremental, false);
+        assert.equal(result.snapshot, undefined);
+      });
+  });
+
+  it("can refresh references incrementally", function() {
+    var repository = this.repository;
+    var branchName = "refresh-references-branch";
+    var snapshot;
+
+    return repository.refreshReferences({ incremental: true })
+      .then(function(result) {
+        assert.equal(result.isIncremental, false);
+        assert.equal("number", typeof result.snapshot);
+        snapshot = result.snapshot;
+
+        return repository.refreshReferences({
+          incremental: true,
+          since: snapshot
+        });
+      })
+      .then(function(result) {
+        assert.equal(result.isIncremental, true);
+        assert.equal(result.refs.length, 0);
+        assert.equal(result.removedRefs.length, 0);
+        snapshot = result.snapshot;
+
+        return repository.getHeadCommit();
+      })
+      .then(function(commit) {
+        return repository.createBranch(branchName, commit, true);
+      })
+      .then(function() {
+        return repository.refreshReferences({
+          incremental: true,
+          since: snapshot
+        });
+      })
+      .then(function(result) {
+        assert.equal(result.isIncremental, true);
+        assert.deepEqual(result.refs.map(function(ref) {
+          return ref.fullName;
+        }), ["refs/heads/" + branchName]);
+        snapshot = result.snapshot;
+
+        return NodeGit.Branch.lookup(
+          repository,
+          branchName,
+          NodeGit.Branch.BRANCH.LOCAL
+        );
+      })
+      .then(function(branch) {
+        NodeGit.Branch.delete(branch);
+        return repository.refreshReferences({
+          incremental: true,
+          since: snapshot
+        });
+      })
+      .then(function(result) {
+        assert.equal(result.refs.length, 0);
+        assert.deepEqual(result.removedRefs, ["refs/heads/" + branchName]);
+      });
+  });
+
+  it("can refresh references since the same snapshot twice", function() {
+    var repository = this.repository;
+    var snapshot;
+
+    return repository.refreshReferences({ incremental: true })
+      .then(function(result) {
+        snapshot = result.snapshot;
+        return repository.refreshReferences({
+          incremental: true,
+          since: snapshot
+        });
+      })
+      .then(function() {
+        return repository.refreshReferences({
+          incremental: true,
+          since: snapshot
+        });
+      })
+      .then(function(result) {
+        assert.equal(result.isIncremental, true);
+        assert.equal(result.refs.length, 0);
+      });
+  });
+
+  it("rejects a snapshot of another repository", function() {
+    var emptyRepo = this.emptyRepo;
+
+    return this.repository.refreshReferences({ incremental: true })
+      .then(function(result) {
+        return emptyRepo.refreshReferences({
+          incremental: true,
+          since: result.snapshot
+        });
+      })
+      .then(function() {
+        assert.fail("Should not refresh since a snapshot of another repo");
+      }, function(error) {
+        assert.equal(error.errno, NodeGit.Error.CODE.ENOTFOUND);
+      });
+  });
+
   it("returns null if there is no head commit", function() {
     return this.emptyRepo.getHeadCommit()
       .then(function(commit) {
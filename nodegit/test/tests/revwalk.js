@@ -157,6 +157,83 @@ describe("Revwalk", function() {
       });
   });
 
+  it("can walk commits as plain objects", function() {
+    var test = this;
+
+    return test.walker.commitWalk(10, { returnPlainObjects: true })
+      .then(function(commits) {
+        assert.equal(commits.length, 10);
+        assert.equal(commits[0].sha, test.commit.sha());
+        assert.equal(commits[0].parents[0], commits[1].sha);
+
+        var author = commits[0].author;
+        assert.equal(author.name, test.commit.author().name());
+        assert.equal(author.email, test.commit.author().email());
+        assert.equal(
+          author.full,
+          author.name + " <" + author.email + ">"
+        );
+      });
+  });
+
+  it("can walk commits in chunks", function() {
+    var chunks = this.walker.commitChunks({ chunkSize: 400 });
+    var sizes = [];
+
+    function walkChunks() {
+      return chunks.next().then(function(result) {
+        if (result.done) {
+          return;
+        }
+        assert.ok(result.value[0] instanceof NodeGit.Commit);
+        sizes.push(result.value.length);
+        return walkChunks();
+      });
+    }
+
+    return walkChunks().then(function() {
+      assert.deepEqual(sizes, [400, 400, 190]);
+    });
+  });
+
+  it("can iterate over commits", function() {
+    var commits = this.walker.commits({ chunkSize: 3 });
+    var magicSha = "b8a94aefb22d0534cc0e5acf533989c13d8725dc";
+    var shas = [];
+
+    function iterate() {
+      return commits.next().then(function(result) {
+        if (result.done) {
+          return;
+        }
+        shas.push(result.value.sha());
+        return iterate();
+      });
+    }
+
+    return iterate().then(function() {
+      assert.equal(shas.length, 990);
+      assert.equal(shas[3], magicSha);
+    });
+  });
+
+  it("can stop iterating over commits early", function() {
+    var test = this;
+    var commits = test.walker.commits({ chunkSize: 2 });
+
+    return commits.next()
+      .then(function() {
+        return commits.return();
+      })
+      .then(function(result) {
+        assert.ok(result.done);
+        return commits.next();
+      })
+      .then(function(result) {
+        assert.ok(result.done);
+      });
+  });
+
   it("can get the history of a file", function() {
     var test = this;
     var magicShas = [
@@ -211,6 +288,171 @@ describe("Revwalk", function() {
       });
   });
 
+  it("can get the history of a file in pages", function() {
+    var test = this;
+    var filePath = "include/functions/copy.h";
+    var pagedShas = [];
+
+    function walkPage(cursor) {
+      var walker = test.walker;
+      if (cursor) {
+        walker = test.repository.createRevWalk();
+        walker.sorting(NodeGit.Revwalk.SORT.TIME);
+      }
+
+      return walker.fileHistoryWalk(filePath, 50, { cursor: cursor })
+        .then(function(results) {
+          results.forEach(function(result) {
+            pagedShas.push(result.commit.sha());
+          });
+          if (results.reachedEndOfHistory) {
+            assert.equal(undefined, results.cursor);
+            return;
+          }
+          assert.ok(results.cursor);
+          return walkPage(results.cursor);
+        });
+    }
+
+    return walkPage(null)
+      .then(function() {
+        var walker = test.repository.createRevWalk();
+        walker.sorting(NodeGit.Revwalk.SORT.TIME);
+        walker.push(test.commit.id());
+        return walker.fileHistoryWalk(filePath, 1000);
+      })
+      .then(function(results) {
+        var shas = results.map(function(result) {
+          return result.commit.sha();
+        });
+        assert.deepEqual(shas, pagedShas);
+      });
+  });
+
+  // Walks the history of filePath in pages on walkers set up by setUp, and
+  // resolves to whether that gives the same commits as a single walk
+  function pagesMatchSingleWalk(test, filePath, setUp) {
+    var pagedShas = [];
+
+    function walkPage(cursor) {
+      var walker = test.repository.createRevWalk();
+      walker.sorting(NodeGit.Revwalk.SORT.TIME);
+      if (!cursor) {
+        setUp(walker);
+      }
+
+      return walker.fileHistoryWalk(filePath, 50, { cursor: cursor })
+        .then(function(results) {
+          results.forEach(function(result) {
+            pagedShas.push(result.commit.sha());
+          });
+          if (!results.reachedEndOfHistory) {
+            return walkPage(results.cursor);
+          }
+        });
+    }
+
+    return walkPage(null)
+      .then(function() {
+        var walker = test.repository.createRevWalk();
+        walker.sorting(NodeGit.Revwalk.SORT.TIME);
+        setUp(walker);
+        return walker.fileHistoryWalk(filePath, 100000);
+      })
+      .then(function(results) {
+        assert.deepEqual(results.map(function(result) {
+          return result.commit.sha();
+        }), pagedShas);
+      });
+  }
+
+  it("can get the history of a file in pages from several commits",
+  function() {
+    var test = this;
+
+    return test.repository.getBranchCommit("master")
+      .then(function(master) {
+        return pagesMatchSingleWalk(test, "README.md", function(walker) {
+          walker.push(test.commit.id());
+          walker.push(master.id());
+        });
+      });
+  });
+
+  it("keeps hidden commits hidden in every page", function() {
+    var test = this;
+    var filePath = "include/functions/copy.h";
+
+    return test.walker.fileHistoryWalk(filePath, 1000)
+      .then(function(results) {
+        var hiddenId = results[1].commit.id();
+        return pagesMatchSingleWalk(test, filePath, function(walker) {
+          walker.push(test.commit.id());
+          walker.hide(hiddenId);
+        });
+      });
+  });
+
+  it("gets the same history with and without the cache", function() {
+    var test = this;
+    var filePath = "include/functions/copy.h";
+    var cachedShas;
+
+    return test.walker.fileHistoryWalk(filePath, 1000)
+      .then(function(results) {
+        cachedShas = results.map(function(result) {
+          return result.commit.sha();
+        });
+
+        var walker = test.repository.createRevWalk();
+        walker.sorting(NodeGit.Revwalk.SORT.TIME);
+        walker.push(test.commit.id());
+        return walker.fileHistoryWalk(filePath, 1000, { useCache: false });
+      })
+      .then(function(results) {
+        var shas = results.map(function(result) {
+          return result.commit.sha();
+        });
+        assert.deepEqual(shas, cachedShas);
+      });
+  });
+
+  it("can limit the history of a file to its directory", function() {
+    var test = this;
+    var filePath = "include/functions/copy.h";
+    var shas;
+
+    return test.walker.fileHistoryWalk(filePath, 1000)
+      .then(function(results) {
+        shas = results.map(function(result) {
+          return result.commit.sha();
+        });
+
+        var walker = test.repository.createRevWalk();
+        walker.sorting(NodeGit.Revwalk.SORT.TIME);
+        walker.push(test.commit.id());
+        return walker.fileHistoryWalk(filePath, 1000, {
+          limitToDirectory: true
+        });
+      })
+      .then(function(results) {
+        assert.deepEqual(results.map(function(result) {
+          return result.commit.sha();
+        }), shas);
+      });
+  });
+
+  it("rejects an invalid file history cursor", function() {
+    var walker = this.repository.createRevWalk();
+
+    return walker.fileHistoryWalk("README.md", 10, { cursor: { pending: 1 } })
+      .then(function() {
+        assert.fail("Should not have walked with an invalid cursor");
+      }, function(error) {
+        assert.ok(/Cursor must be/.test(error.message));
+      });
+  });
+
   it("can get the history of a file while ignoring parallel branches",
   function() {
     var test = this;
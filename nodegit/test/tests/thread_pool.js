@@ -0,0 +1,268 @@
+var assert = require("assert");
+var path = require("path");
+var local = path.join.bind(path, __dirname);
+
+describe("ThreadPool", function() {
+  var NodeGit = require("../../");
+  var Repository = NodeGit.Repository;
+  var Commit = NodeGit.Commit;
+
+  var reposPath = local("../repos/workdir");
+
+  beforeEach(function() {
+    var test = this;
+
+    return Repository.open(reposPath)
+      .then(function(repo) {
+        test.repository = repo;
+      });
+  });
+
+  it("reports its size", function() {
+    assert.ok(NodeGit.getThreadPoolSize() > 0);
+  });
+
+  it("cannot be resized once asynchronous work has been queued", function() {
+    assert.throws(function() {
+      NodeGit.setThreadPoolSize(NodeGit.getThreadPoolSize() + 1);
+    }, /after the first asynchronous call/);
+  });
+
+  it("rejects invalid sizes", function() {
+    assert.throws(function() {
+      NodeGit.setThreadPoolSize(0);
+    }, /at least 1/);
+
+    assert.throws(function() {
+      NodeGit.setThreadPoolSize("4");
+    }, /must be a Number/);
+  });
+
+  it("can change the completion budget", function() {
+    var originalBudget = NodeGit.getThreadPoolCompletionBudget();
+
+    NodeGit.setThreadPoolCompletionBudget(0.5);
+    assert.equal(0.5, NodeGit.getThreadPoolCompletionBudget());
+
+    assert.throws(function() {
+      NodeGit.setThreadPoolCompletionBudget(-1);
+    }, /must not be negative/);
+
+    NodeGit.setThreadPoolCompletionBudget(originalBudget);
+  });
+
+  it("completes many concurrent asynchronous calls", function() {
+    var repository = this.repository;
+
+    return repository.getHeadCommit()
+      .then(function(head) {
+        var lookups = [];
+        for (var i = 0; i < 500; i++) {
+          lookups.push(Commit.lookup(repository, head.id()));
+        }
+        return Promise.all(lookups)
+          .then(function(commits) {
+            commits.forEach(function(commit) {
+              assert.equal(commit.sha(), head.sha());
+            });
+          });
+      });
+  });
+
+  it("completes every call when the completion budget is tiny", function() {
+    var repository = this.repository;
+    var originalBudget = NodeGit.getThreadPoolCompletionBudget();
+
+    // a budget this small forces completions to be spread over many ticks
+    NodeGit.setThreadPoolCompletionBudget(0.000001);
+
+    return repository.getHeadCommit()
+      .then(function(head) {
+        var lookups = [];
+        for (var i = 0; i < 500; i++) {
+          lookups.push(Commit.lookup(repository, head.id()));
+        }
+        return Promise.all(lookups);
+      })
+      .then(function(commits) {
+        assert.equal(500, commits.length);
+        NodeGit.setThreadPoolCompletionBudget(originalBudget);
+      }, function(error) {
+        NodeGit.setThreadPoolCompletionBudget(originalBudget);
+        throw error;
+      });
+  });
+
+  it("can queue calls with a priority", function() {
+    var repository = this.repository;
+    var BULK = NodeGit.THREAD_POOL_PRIORITY.BULK;
+    var startedBefore = NodeGit.getThreadPoolStats().bulk.started;
+
+    return NodeGit.withThreadPoolPriority(BULK, function() {
+      assert.equal(BULK, NodeGit.getThreadPoolPriority());
+      return repository.getHeadCommit();
+    })
+      .then(function(commit) {
+        assert.ok(commit);
+        assert.equal(null, NodeGit.getThreadPoolPriority());
+        assert.ok(NodeGit.getThreadPoolStats().bulk.started > startedBefore);
+      });
+  });
+
+  it("can set the priority of a repository", function() {
+    var repository = this.repository;
+    var BACKGROUND = NodeGit.THREAD_POOL_PRIORITY.BACKGROUND;
+    var startedBefore = NodeGit.getThreadPoolStats().background.started;
+
+    repository.setThreadPoolPriority(BACKGROUND);
+    return repository.getHeadCommit()
+      .then(function(commit) {
+        repository.setThreadPoolPriority(null);
+        assert.ok(commit);
+        assert.ok(
+          NodeGit.getThreadPoolStats().background.started > startedBefore
+        );
+      });
+  });
+
+  it("completes calls with affinity scheduling", function() {
+    var repository = this.repository;
+
+    assert.equal(false, NodeGit.getThreadPoolAffinity());
+    NodeGit.setThreadPoolAffinity(true);
+    assert.equal(true, NodeGit.getThreadPoolAffinity());
+
+    assert.throws(function() {
+      NodeGit.setThreadPoolAffinity("yes");
+    }, /must be a Boolean/);
+
+    return repository.getHeadCommit()
+      .then(function(head) {
+        var walks = [];
+        for (var i = 0; i < 50; i++) {
+          walks.push(head.getParents(1));
+        }
+        return Promise.all(walks);
+      })
+      .then(function(parents) {
+        NodeGit.setThreadPoolAffinity(false);
+        assert.equal(50, parents.length);
+      }, function(error) {
+        NodeGit.setThreadPoolAffinity(false);
+        throw error;
+      });
+  });
+
+  it("rejects invalid priorities", function() {
+    assert.throws(function() {
+      NodeGit.setThreadPoolPriority(3);
+    }, /THREAD_POOL_PRIORITY/);
+  });
+
+  it("reports queue statistics per priority", function() {
+    var stats = NodeGit.getThreadPoolStats();
+
+    ["interactive", "bulk", "background"].forEach(function(priority) {
+      assert.equal("number", typeof stats[priority].queued);
+      assert.equal("number", typeof stats[priority].started);
+      assert.equal("number", typeof stats[priority].averageWaitMs);
+      assert.equal("number", typeof stats[priority].maxWaitMs);
+    });
+  });
+
+  it("looks up cached objects without queueing work", function() {
+    var repository = this.repository;
+
+    return repository.getHeadCommit()
+      .then(function(head) {
+        var startedBefore = NodeGit.getThreadPoolStats().interactive.started;
+        var lookups = [];
+        for (var i = 0; i < 10; i++) {
+          lookups.push(Commit.lookup(repository, head.id()));
+        }
+        return Promise.all(lookups)
+          .then(function(commits) {
+            commits.forEach(function(commit) {
+              assert.equal(commit.sha(), head.sha());
+            });
+            assert.equal(
+              startedBefore,
+              NodeGit.getThreadPoolStats().interactive.started
+            );
+          });
+      });
+  });
+
+  it("recycles the batons and workers of asynchronous calls", function() {
+    var repository = this.repository;
+    var before = NodeGit.getObjectPoolStats();
+
+    return repository.getHeadCommit()
+      .then(function(head) {
+        var lookups = [];
+        for (var i = 0; i < 100; i++) {
+          lookups.push(Commit.lookup(repository, head.id()));
+        }
+        return Promise.all(lookups);
+      })
+      .then(function() {
+        return repository.getHeadCommit();
+      })
+      .then(function() {
+        var after = NodeGit.getObjectPoolStats();
+        assert.ok(after.reused > before.reused);
+        assert.ok(after.recycled > before.recycled);
+        assert.equal("number", typeof after.allocated);
+        assert.equal("number", typeof after.freed);
+      });
+  });
+
+  it("records per call stats only while enabled", function() {
+    var repository = this.repository;
+
+    NodeGit.resetStats();
+    assert.equal(false, NodeGit.isStatsEnabled());
+
+    return repository.getHeadCommit()
+      .then(function(head) {
+        assert.equal(undefined, NodeGit.getStats()["Commit.lookup"]);
+
+        NodeGit.setStatsEnabled(true);
+        var lookups = [];
+        for (var i = 0; i < 10; i++) {
+          lookups.push(Commit.lookup(repository, head.id()));
+        }
+        return Promise.all(lookups);
+      })
+      .then(function() {
+        NodeGit.setStatsEnabled(false);
+
+        var stats = NodeGit.getStats()["Commit.lookup"];
+        ["queueWait", "lockWait", "execution", "completionDelay"]
+          .forEach(function(name) {
+            assert.equal(10, stats[name].count);
+            assert.ok(stats[name].maxMs >= stats[name].p50Ms);
+            assert.ok(stats[name].averageMs >= 0);
+          });
+
+        NodeGit.resetStats();
+        assert.equal(undefined, NodeGit.getStats()["Commit.lookup"]);
+      }, function(error) {
+        NodeGit.setStatsEnabled(false);
+        throw error;
+      });
+  });
+
+  it("can change the number of reserved workers", function() {
+    var originalReservedWorkers = NodeGit.getThreadPoolReservedWorkers();
+
+    NodeGit.setThreadPoolReservedWorkers(0);
+    assert.equal(0, NodeGit.getThreadPoolReservedWorkers());
+
+    assert.throws(function() {
+      NodeGit.setThreadPoolReservedWorkers(NodeGit.getThreadPoolSize());
+    }, /less than the thread pool size/);
+
+    NodeGit.setThreadPoolReservedWorkers(originalReservedWorkers);
+  });
+});
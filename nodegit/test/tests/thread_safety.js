@@ -62,4 +62,66 @@ describe("ThreadSafety", function() {
         assert.equal(0, diagnostics.storedMutexesCount);
     }
   });
+
+  it("reports lock contention counters", function() {
+    var before = NodeGit.getThreadSafetyDiagnostics();
+    assert.equal("number", typeof before.lockedMutexesCount);
+    assert.equal("number", typeof before.contendedMutexesCount);
+    assert.equal("number", typeof before.contendedShardsCount);
+
+    this.repository.headDetached();
+
+    var after = NodeGit.getThreadSafetyDiagnostics();
+    if (NodeGit.getThreadSafetyStatus() === NodeGit.THREAD_SAFETY.ENABLED) {
+      assert.ok(after.lockedMutexesCount > before.lockedMutexesCount);
+    }
+    assert.ok(after.contendedMutexesCount >= before.contendedMutexesCount);
+  });
+
+  it("can take shared locks for read-only calls", function() {
+    var originalValue = NodeGit.getThreadSafetyReadWriteLocking();
+
+    NodeGit.setThreadSafetyReadWriteLocking(true);
+    assert.equal(true, NodeGit.getThreadSafetyReadWriteLocking());
+
+    var before = NodeGit.getThreadSafetyDiagnostics();
+    // headDetached is annotated as read-only
+    this.repository.headDetached();
+    var after = NodeGit.getThreadSafetyDiagnostics();
+
+    NodeGit.setThreadSafetyReadWriteLocking(originalValue);
+
+    if (NodeGit.getThreadSafetyStatus() === NodeGit.THREAD_SAFETY.ENABLED) {
+      assert.ok(after.sharedMutexesCount > before.sharedMutexesCount);
+    } else {
+      assert.equal(before.sharedMutexesCount, after.sharedMutexesCount);
+    }
+
+    assert.throws(function() {
+      NodeGit.setThreadSafetyReadWriteLocking(1);
+    }, /must be a Boolean/);
+  });
+
+  it("serves concurrent readers of one repository", function() {
+    var repository = this.repository;
+    var originalValue = NodeGit.getThreadSafetyReadWriteLocking();
+
+    NodeGit.setThreadSafetyReadWriteLocking(true);
+    return repository.getHeadCommit()
+      .then(function(head) {
+        var lookups = [];
+        for (var i = 0; i < 100; i++) {
+          lookups.push(NodeGit.Commit.lookup(repository, head.id()));
+          lookups.push(head.getEntry("README.md"));
+        }
+        return Promise.all(lookups);
+      })
+      .then(function(results) {
+        NodeGit.setThreadSafetyReadWriteLocking(originalValue);
+        assert.equal(200, results.length);
+      }, function(error) {
+        NodeGit.setThreadSafetyReadWriteLocking(originalValue);
+        throw error;
+      });
+  });
 });